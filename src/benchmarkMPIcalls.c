@@ -22,9 +22,13 @@
  */
 
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include <math.h>
+#include <gsl/gsl_statistics.h>
+#include <gsl/gsl_sort.h>
 #include "mpi.h"
 
 #include "reprompi_bench/misc.h"
@@ -40,11 +44,43 @@
 #include "reprompi_bench/output_management/results_output.h"
 #include "collective_ops/collectives.h"
 #include "reprompi_bench/utils/keyvalue_store.h"
+#include "reprompi_bench/utils/timestamp_arena.h"
 
 static const int OUTPUT_ROOT_PROC = 0;
 static const int HASHTABLE_SIZE=100;
 
-void print_initial_settings(const reprompib_options_t* opts, const reprompib_common_options_t* common_opts, print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict) {
+// automatic warm-up: blocks of calls are run until the median runtime of a block
+// differs by at most WARMUP_TOLERANCE from the median of the previous block
+#define WARMUP_BLOCK_SIZE 10
+static const double WARMUP_TOLERANCE = 0.05;
+static const long WARMUP_MAX_CALLS = 10000;
+
+// time-budgeted runs: repetitions of each job in the pilot run and
+// in the first batch of its measurements (the following batches are twice as large)
+static const long BUDGET_PILOT_NREP = 10;
+static const long BUDGET_MIN_BATCH = 10;
+static const double MEDIAN_CI_Z = 1.96;   // 95% confidence
+
+/* prints a header line (on the root process) to stdout and appends it to the output file */
+static void print_header_key(const reprompib_common_options_t* common_opts, const char* format, ...) {
+    va_list args;
+    FILE* f;
+
+    va_start(args, format);
+    vfprintf(stdout, format, args);
+    va_end(args);
+    if (common_opts->output_file != NULL) {
+        f = fopen(common_opts->output_file, "a");
+        va_start(args, format);
+        vfprintf(f, format, args);
+        va_end(args);
+        fflush(f);
+        fclose(f);
+    }
+}
+
+void print_initial_settings(const reprompib_options_t* opts, const reprompib_common_options_t* common_opts, print_sync_info_t print_sync_info, const reprompib_dictionary_t* dict,
+        const int arena_locked, const int arena_huge_pages) {
     int my_rank, np;
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
@@ -53,25 +89,42 @@ void print_initial_settings(const reprompib_options_t* opts, const reprompib_com
     print_common_settings(common_opts, print_sync_info, dict);
 
     if (my_rank == OUTPUT_ROOT_PROC) {
-        FILE* f;
-
-        f = stdout;
         if (opts->n_rep > 0) {
-          fprintf(f, "#@nrep=%ld\n", opts->n_rep);
-          if (common_opts->output_file != NULL) {
-            f = fopen(common_opts->output_file, "a");
-            fprintf(f, "#@nrep=%ld\n", opts->n_rep);
-            fflush(f);
-            fclose(f);
-          }
+          print_header_key(common_opts, "#@nrep=%ld\n", opts->n_rep);
+        }
+        if (opts->raw_ticks) {
+          print_header_key(common_opts, "#@raw_ticks=1\n");
+        }
+        if (opts->n_inner > 1) {
+          print_header_key(common_opts, "#@inner_iterations=%ld\n", opts->n_inner);
+        }
+        if (opts->warmup_auto) {
+          print_header_key(common_opts, "#@warmup=auto\n");
+        } else if (opts->n_warmup > 0) {
+          print_header_key(common_opts, "#@warmup=%ld\n", opts->n_warmup);
+        }
+        if (opts->n_rounds > 0) {
+          print_header_key(common_opts, "#@interleave_rounds=%ld\n", opts->n_rounds);
+          print_header_key(common_opts, "#@interleave_seed=%u\n", opts->seed);
+        }
+        if (opts->time_budget_s > 0) {
+          print_header_key(common_opts, "#@time_budget_s=%.6f\n", opts->time_budget_s);
+          print_header_key(common_opts, "#@ci_width=%.6f\n", opts->ci_width);
+        }
+        if (opts->timer_correction) {
+          print_header_key(common_opts, "#@timer_correction=1\n");
+        }
+        if (opts->lock_memory || opts->huge_pages) {
+          print_header_key(common_opts, "#@timestamps_locked=%d\n", arena_locked);
+          print_header_key(common_opts, "#@timestamps_huge_pages=%d\n", arena_huge_pages);
         }
     }
 }
 
-
 void reprompib_print_bench_output(job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
-        const reprompib_options_t* opts, const reprompib_common_options_t* common_opts) {
+        const reprompi_raw_ticks_t* raw_ticks, sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time, sync_start_errors_t get_start_errors,
+        sync_window_slack_t get_window_slack, const reprompib_options_t* opts, const reprompib_common_options_t* common_opts,
+        const int print_n_inner) {
     FILE* f = stdout;
     int my_rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
@@ -83,19 +136,19 @@ void reprompib_print_bench_output(job_t job, double* tstart_sec, double* tend_se
     }
 
     if (opts->print_summary_methods >0)  {
-        print_summary(stdout, job, tstart_sec, tend_sec, get_errorcodes, get_global_time,
-                opts->print_summary_methods);
+        print_summary(stdout, job, tstart_sec, tend_sec, raw_ticks, get_errorcodes, get_global_time,
+                opts->print_summary_methods, print_n_inner);
         if (common_opts->output_file != NULL) {
-            print_measurement_results(f, job, tstart_sec, tend_sec,
-                    get_errorcodes, get_global_time,
-                    opts->verbose);
+            print_measurement_results(f, job, tstart_sec, tend_sec, raw_ticks,
+                    get_errorcodes, get_global_time, get_start_errors, get_window_slack,
+                    opts->verbose, print_n_inner);
         }
 
     }
     else {
-        print_measurement_results(f, job, tstart_sec, tend_sec,
-                get_errorcodes, get_global_time,
-                opts->verbose);
+        print_measurement_results(f, job, tstart_sec, tend_sec, raw_ticks,
+                get_errorcodes, get_global_time, get_start_errors, get_window_slack,
+                opts->verbose, print_n_inner);
     }
 
     if (my_rank == OUTPUT_ROOT_PROC) {
@@ -108,6 +161,473 @@ void reprompib_print_bench_output(job_t job, double* tstart_sec, double* tend_se
 }
 
 
+/* untimed calls before the measurements of a job, returns the number of calls */
+static long run_warmup(const job_t* job, collective_params_t* coll_params, const reprompib_options_t* opts) {
+    long i, n_calls;
+    double runtimes[WARMUP_BLOCK_SIZE];
+    double median, prev_median;
+    double tstart;
+
+    if (!opts->warmup_auto) {
+        for (i = 0; i < opts->n_warmup; i++) {
+            collective_calls[job->call_index].collective_call(coll_params);
+        }
+        return opts->n_warmup;
+    }
+
+    n_calls = 0;
+    prev_median = -1;
+    while (n_calls < WARMUP_MAX_CALLS) {
+        for (i = 0; i < WARMUP_BLOCK_SIZE; i++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            tstart = get_time();
+            collective_calls[job->call_index].collective_call(coll_params);
+            runtimes[i] = get_time() - tstart;
+        }
+        n_calls += WARMUP_BLOCK_SIZE;
+
+        gsl_sort(runtimes, 1, WARMUP_BLOCK_SIZE);
+        median = gsl_stats_median_from_sorted_data(runtimes, 1, WARMUP_BLOCK_SIZE);
+        // all processes have to agree on when to stop
+        MPI_Allreduce(MPI_IN_PLACE, &median, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (prev_median > 0 && median - prev_median <= WARMUP_TOLERANCE * prev_median
+                && prev_median - median <= WARMUP_TOLERANCE * prev_median) {
+            break;
+        }
+        prev_median = median;
+    }
+    return n_calls;
+}
+
+static void print_warmup_calls(const long n_calls, const reprompib_common_options_t* common_opts) {
+    int my_rank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        print_header_key(common_opts, "#@warmup_calls=%ld\n", n_calls);
+    }
+}
+
+
+/* the end timestamps are moved back by the overhead of one timer call, but not before the start */
+static void subtract_timer_overhead(const long n_rep, const double* tstart_sec, double* tend_sec) {
+    long i;
+    double overhead = reprompi_get_timer_overhead();
+
+    for (i = 0; i < n_rep; i++) {
+        tend_sec[i] -= overhead;
+        if (tend_sec[i] < tstart_sec[i]) {
+            tend_sec[i] = tstart_sec[i];
+        }
+    }
+}
+
+static void subtract_timer_overhead_ticks(const long n_rep, const reprompi_ticks_t* tstart_ticks, reprompi_ticks_t* tend_ticks) {
+    long i;
+    reprompi_ticks_t overhead = reprompi_get_timer_overhead_ticks();
+
+    for (i = 0; i < n_rep; i++) {
+        if (tend_ticks[i] - tstart_ticks[i] > overhead) {
+            tend_ticks[i] -= overhead;
+        } else {
+            tend_ticks[i] = tstart_ticks[i];
+        }
+    }
+}
+
+
+/* execute the repetitions first_rep, ..., first_rep + n_rep - 1 of a job */
+static void measure_repetitions(const job_t* job, collective_params_t* coll_params, const long first_rep,
+        const long n_rep, const reprompib_sync_functions_t* sync_f, const int use_raw_ticks,
+        double* tstart_sec, double* tend_sec, reprompi_ticks_t* tstart_ticks, reprompi_ticks_t* tend_ticks) {
+    long i, k;
+
+    if (use_raw_ticks) {
+        // the ticks are converted to seconds when the runtimes are computed
+        for (i = first_rep; i < first_rep + n_rep; i++) {
+            sync_f->start_sync();
+
+            tstart_ticks[i] = get_ticks();
+            for (k = 0; k < job->n_inner; k++) {
+                collective_calls[job->call_index].collective_call(coll_params);
+            }
+            tend_ticks[i] = get_ticks();
+
+            sync_f->stop_sync();
+        }
+    } else {
+        for (i = first_rep; i < first_rep + n_rep; i++) {
+            sync_f->start_sync();
+
+            tstart_sec[i] = sync_f->get_time();
+            for (k = 0; k < job->n_inner; k++) {
+                collective_calls[job->call_index].collective_call(coll_params);
+            }
+            tend_sec[i] = sync_f->get_time();
+
+            sync_f->stop_sync();
+        }
+    }
+}
+
+
+// synchronization results of the job that is printed, when the synchronization module was
+// not initialized for exactly the repetitions of this job (interleaved or time-budgeted runs)
+static int* job_errorcodes = NULL;
+static double* job_start_errors = NULL;
+static double* job_window_slack = NULL;
+
+static int* get_job_errorcodes(void) {
+    return job_errorcodes;
+}
+
+static double* get_job_start_errors(void) {
+    return job_start_errors;
+}
+
+static double* get_job_window_slack(void) {
+    return job_window_slack;
+}
+
+static void alloc_job_sync_results(const long max_nrep, const reprompib_sync_functions_t* sync_f,
+        sync_window_slack_t get_window_slack) {
+    if (sync_f->get_errorcodes != NULL) {
+        job_errorcodes = (int*) calloc(max_nrep, sizeof(int));
+    }
+    if (sync_f->get_start_errors != NULL) {
+        job_start_errors = (double*) calloc(max_nrep, sizeof(double));
+    }
+    if (get_window_slack != NULL) {
+        job_window_slack = (double*) calloc(max_nrep, sizeof(double));
+    }
+}
+
+static void free_job_sync_results(void) {
+    free(job_errorcodes);
+    free(job_start_errors);
+    free(job_window_slack);
+    job_errorcodes = NULL;
+    job_start_errors = NULL;
+    job_window_slack = NULL;
+}
+
+
+/*
+ * Split the jobs into rounds and execute the rounds of all jobs in random order,
+ * with a single clock synchronization and one synchronization module for all repetitions.
+ * The timestamps of job j are stored at offset j in the arena arrays.
+ */
+static void run_interleaved_jobs(const job_list_t* jlist, const basic_collective_params_t coll_basic_info,
+        const reprompib_sync_options_t sync_opts, const reprompib_sync_functions_t* sync_f,
+        const reprompib_options_t* opts, const reprompib_common_options_t* common_opts,
+        const reprompib_dictionary_t* params_dict, const reprompi_timestamp_arena_t* arena,
+        const int arena_status[2], sync_window_slack_t get_window_slack) {
+    long i, j, r;
+    long total_nrep, max_nrep, stream_rep;
+    int print_n_inner;
+    long* offsets;
+    long* stream_index;
+    long* n_warmup_calls;
+    collective_params_t* coll_params;
+    job_schedule_t schedule;
+    double* tstart_sec = NULL;
+    double* tend_sec = NULL;
+    reprompi_ticks_t* tstart_ticks = NULL;
+    reprompi_ticks_t* tend_ticks = NULL;
+    reprompi_raw_ticks_t raw_ticks;
+
+    offsets = (long*) malloc(jlist->n_jobs * sizeof(long));
+    n_warmup_calls = (long*) calloc(jlist->n_jobs, sizeof(long));
+    coll_params = (collective_params_t*) malloc(jlist->n_jobs * sizeof(collective_params_t));
+    total_nrep = 0;
+    max_nrep = 0;
+    for (j = 0; j < jlist->n_jobs; j++) {
+        offsets[j] = total_nrep;
+        total_nrep += jlist->jobs[j].n_rep;
+        if (jlist->jobs[j].n_rep > max_nrep) {
+            max_nrep = jlist->jobs[j].n_rep;
+        }
+    }
+    // position of each repetition in the sequence of all measured repetitions
+    stream_index = (long*) malloc(total_nrep * sizeof(long));
+
+    generate_round_schedule(jlist, opts->n_rounds, opts->seed, &schedule);
+
+    if (opts->raw_ticks) {
+        tstart_ticks = (reprompi_ticks_t*) reprompi_arena_get_array(arena, 0, total_nrep, sizeof(reprompi_ticks_t));
+        tend_ticks = (reprompi_ticks_t*) reprompi_arena_get_array(arena, 1, total_nrep, sizeof(reprompi_ticks_t));
+    } else {
+        tstart_sec = (double*) reprompi_arena_get_array(arena, 0, total_nrep, sizeof(double));
+        tend_sec = (double*) reprompi_arena_get_array(arena, 1, total_nrep, sizeof(double));
+    }
+
+    // the synchronization module keeps its state for the repetitions of all jobs
+    sync_f->init_sync_module(sync_opts, total_nrep);
+
+    print_initial_settings(opts, common_opts, sync_f->print_sync_info, params_dict,
+            arena_status[0], arena_status[1]);
+    print_n_inner = jobs_use_inner_iterations(jlist);
+    print_results_header(opts, common_opts->output_file, opts->verbose, sync_f->get_errorcodes,
+            sync_f->get_start_errors, get_window_slack, print_n_inner);
+
+    // the buffers of all jobs are allocated for the whole run
+    for (i = 0; i < jlist->n_jobs; i++) {
+        j = jlist->job_indices[i];
+        collective_calls[jlist->jobs[j].call_index].initialize_data(coll_basic_info, jlist->jobs[j].count,
+                &coll_params[j]);
+        n_warmup_calls[j] = run_warmup(&jlist->jobs[j], &coll_params[j], opts);
+    }
+
+    sync_f->sync_clocks();
+    sync_f->init_sync();
+
+    stream_rep = 0;
+    for (r = 0; r < schedule.n_rounds; r++) {
+        const job_round_t* round = &schedule.rounds[r];
+
+        j = round->job_index;
+        measure_repetitions(&jlist->jobs[j], &coll_params[j], offsets[j] + round->first_rep, round->n_rep, sync_f,
+                opts->raw_ticks, tstart_sec, tend_sec, tstart_ticks, tend_ticks);
+        for (i = 0; i < round->n_rep; i++) {
+            stream_index[offsets[j] + round->first_rep + i] = stream_rep++;
+        }
+    }
+
+    if (opts->timer_correction) {
+        if (opts->raw_ticks) {
+            subtract_timer_overhead_ticks(total_nrep, tstart_ticks, tend_ticks);
+        } else {
+            subtract_timer_overhead(total_nrep, tstart_sec, tend_sec);
+        }
+    }
+
+    // merge the results of the rounds of each job
+    alloc_job_sync_results(max_nrep, sync_f, get_window_slack);
+    for (i = 0; i < jlist->n_jobs; i++) {
+        j = jlist->job_indices[i];
+
+        for (r = 0; r < jlist->jobs[j].n_rep; r++) {
+            if (job_errorcodes != NULL) {
+                job_errorcodes[r] = sync_f->get_errorcodes()[stream_index[offsets[j] + r]];
+            }
+            if (job_start_errors != NULL) {
+                job_start_errors[r] = sync_f->get_start_errors()[stream_index[offsets[j] + r]];
+            }
+            if (job_window_slack != NULL) {
+                job_window_slack[r] = get_window_slack()[stream_index[offsets[j] + r]];
+            }
+        }
+
+        if (opts->warmup_auto) {
+            print_warmup_calls(n_warmup_calls[j], common_opts);
+        }
+        raw_ticks.tstart = opts->raw_ticks ? tstart_ticks + offsets[j] : NULL;
+        raw_ticks.tend = opts->raw_ticks ? tend_ticks + offsets[j] : NULL;
+        raw_ticks.ticks_to_time = sync_f->ticks_to_time;
+        reprompib_print_bench_output(jlist->jobs[j],
+                opts->raw_ticks ? NULL : tstart_sec + offsets[j], opts->raw_ticks ? NULL : tend_sec + offsets[j],
+                opts->raw_ticks ? &raw_ticks : NULL,
+                (job_errorcodes != NULL) ? get_job_errorcodes : NULL, sync_f->get_normalized_time,
+                (job_start_errors != NULL) ? get_job_start_errors : NULL,
+                (job_window_slack != NULL) ? get_job_window_slack : NULL,
+                opts, common_opts, print_n_inner);
+    }
+
+    free_job_sync_results();
+
+    for (j = 0; j < jlist->n_jobs; j++) {
+        collective_calls[jlist->jobs[j].call_index].cleanup_data(&coll_params[j]);
+    }
+    sync_f->clean_sync_module();
+
+    cleanup_round_schedule(&schedule);
+    free(stream_index);
+    free(coll_params);
+    free(n_warmup_calls);
+    free(offsets);
+}
+
+
+/* cost of one repetition of each job, measured on the root with barrier-separated calls
+ * (a repetition takes at least one window with window-based synchronization, window_size_sec > 0) */
+static void estimate_repetition_costs(const job_list_t* jlist, const basic_collective_params_t coll_basic_info,
+        const double window_size_sec, double* costs) {
+    int j;
+    long i, k;
+    double tstart;
+    collective_params_t coll_params;
+
+    for (j = 0; j < jlist->n_jobs; j++) {
+        const job_t* job = &jlist->jobs[j];
+
+        collective_calls[job->call_index].initialize_data(coll_basic_info, job->count, &coll_params);
+        MPI_Barrier(MPI_COMM_WORLD);
+        tstart = get_time();
+        for (i = 0; i < BUDGET_PILOT_NREP; i++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            for (k = 0; k < job->n_inner; k++) {
+                collective_calls[job->call_index].collective_call(&coll_params);
+            }
+        }
+        costs[j] = repro_max((get_time() - tstart) / BUDGET_PILOT_NREP, window_size_sec);
+        collective_calls[job->call_index].cleanup_data(&coll_params);
+    }
+    MPI_Bcast(costs, jlist->n_jobs, MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+}
+
+/* width of the confidence interval of the median relative to the median,
+ * computed from order statistics of the sorted runtimes (-1 if there are too few runtimes) */
+static double median_ci_width(const double* sorted_runtimes_sec, const long n) {
+    long lower, upper;
+    double half_width, median;
+
+    if (n < BUDGET_MIN_BATCH) {
+        return -1;
+    }
+    half_width = MEDIAN_CI_Z * sqrt((double) n) / 2;
+    lower = (long) floor(n / 2.0 - half_width);
+    upper = (long) ceil(n / 2.0 + half_width);
+    if (lower < 0) {
+        lower = 0;
+    }
+    if (upper > n - 1) {
+        upper = n - 1;
+    }
+
+    median = gsl_stats_median_from_sorted_data(sorted_runtimes_sec, 1, n);
+    if (median <= 0) {
+        return -1;
+    }
+    return (sorted_runtimes_sec[upper] - sorted_runtimes_sec[lower]) / median;
+}
+
+/*
+ * Measure a job in batches of repetitions until the confidence interval of its median is narrow enough,
+ * its time slice (starting at slice_start on the root) is used up or job->n_rep repetitions were measured.
+ * The windows are restarted for each batch, and the synchronization results of the batches are collected in
+ * the job_* arrays. Returns the number of measured repetitions.
+ */
+static long measure_with_budget(const job_t* job, collective_params_t* coll_params,
+        const reprompib_sync_functions_t* sync_f, const reprompib_options_t* opts,
+        const double slice_start, const double slice_s, sync_window_slack_t get_window_slack,
+        double* tstart_sec, double* tend_sec, reprompi_ticks_t* tstart_ticks, reprompi_ticks_t* tend_ticks,
+        double* ci_width) {
+    int my_rank;
+    long i, n_measured, n_valid;
+    long batch[2];  // stop flag, size of the next batch
+    double* runtimes_sec = NULL;
+    int* errorcodes = NULL;
+    double elapsed_s, rep_cost_s;
+    double measure_start;
+    reprompi_raw_ticks_t raw_ticks;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        runtimes_sec = (double*) malloc(job->n_rep * sizeof(double));
+        if (sync_f->get_errorcodes != NULL) {
+            errorcodes = (int*) malloc(job->n_rep * sizeof(int));
+        }
+    }
+
+    // the cost of a repetition does not include the warm-up and the clock synchronization
+    measure_start = get_time();
+    *ci_width = -1;
+    n_measured = 0;
+    n_valid = 0;
+    batch[0] = 0;
+    batch[1] = (BUDGET_MIN_BATCH < job->n_rep) ? BUDGET_MIN_BATCH : job->n_rep;
+    while (1) {
+        sync_f->init_sync();
+        measure_repetitions(job, coll_params, n_measured, batch[1], sync_f, opts->raw_ticks,
+                tstart_sec, tend_sec, tstart_ticks, tend_ticks);
+
+        if (opts->raw_ticks) {
+            if (opts->timer_correction) {
+                subtract_timer_overhead_ticks(batch[1], tstart_ticks + n_measured, tend_ticks + n_measured);
+            }
+            raw_ticks.tstart = tstart_ticks + n_measured;
+            raw_ticks.tend = tend_ticks + n_measured;
+            raw_ticks.ticks_to_time = sync_f->ticks_to_time;
+            compute_runtimes_by_sync_method_ticks(&raw_ticks, 0, batch[1], OUTPUT_ROOT_PROC,
+                    sync_f->get_errorcodes, sync_f->get_normalized_time, runtimes_sec + n_valid, errorcodes);
+        } else {
+            if (opts->timer_correction) {
+                subtract_timer_overhead(batch[1], tstart_sec + n_measured, tend_sec + n_measured);
+            }
+            compute_runtimes_by_sync_method(tstart_sec + n_measured, tend_sec + n_measured, 0, batch[1],
+                    OUTPUT_ROOT_PROC, sync_f->get_errorcodes, sync_f->get_normalized_time,
+                    runtimes_sec + n_valid, errorcodes);
+        }
+
+        // the synchronization results of the batch are overwritten by the next batch
+        for (i = 0; i < batch[1]; i++) {
+            if (job_errorcodes != NULL) {
+                job_errorcodes[n_measured + i] = sync_f->get_errorcodes()[i];
+            }
+            if (job_start_errors != NULL) {
+                job_start_errors[n_measured + i] = sync_f->get_start_errors()[i];
+            }
+            if (job_window_slack != NULL) {
+                job_window_slack[n_measured + i] = get_window_slack()[i];
+            }
+        }
+
+        n_measured += batch[1];
+
+        if (my_rank == OUTPUT_ROOT_PROC) {
+            long n_batch_valid = 0;
+
+            // only the valid runtimes are kept (their order does not matter)
+            for (i = 0; i < batch[1]; i++) {
+                if (errorcodes == NULL || errorcodes[i] == 0) {
+                    runtimes_sec[n_valid + n_batch_valid] = runtimes_sec[n_valid + i];
+                    n_batch_valid++;
+                }
+            }
+            n_valid += n_batch_valid;
+            gsl_sort(runtimes_sec, 1, n_valid);
+            *ci_width = median_ci_width(runtimes_sec, n_valid);
+
+            // the next batch is twice as large, unless it does not fit into the time slice
+            elapsed_s = get_time() - slice_start;
+            rep_cost_s = (get_time() - measure_start) / n_measured;
+            batch[1] = 2 * batch[1];
+            if (rep_cost_s > 0 && (slice_s - elapsed_s) / rep_cost_s < batch[1]) {
+                batch[1] = (long) ((slice_s - elapsed_s) / rep_cost_s);
+            }
+            if (batch[1] > job->n_rep - n_measured) {
+                batch[1] = job->n_rep - n_measured;
+            }
+
+            batch[0] = (opts->ci_width > 0 && *ci_width >= 0 && *ci_width <= opts->ci_width)
+                    || batch[1] <= 0;
+        }
+        MPI_Bcast(batch, 2, MPI_LONG, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+
+        if (batch[0]) {
+            break;
+        }
+    }
+
+    free(runtimes_sec);
+    free(errorcodes);
+
+    return n_measured;
+}
+
+static void print_budget_info(const double slice_s, const double ci_width,
+        const reprompib_common_options_t* common_opts) {
+    int my_rank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        print_header_key(common_opts, "#@time_slice_s=%.6f\n", slice_s);
+        print_header_key(common_opts, "#@median_ci_width=%.6f\n", ci_width);
+    }
+}
+
+
 void reprompib_parse_bench_options(int argc, char** argv) {
     int c;
     opterr = 0;
@@ -146,8 +666,11 @@ void reprompib_parse_bench_options(int argc, char** argv) {
 int main(int argc, char* argv[]) {
     int my_rank, procs;
     long i, jindex;
-    double* tstart_sec;
-    double* tend_sec;
+    double* tstart_sec = NULL;
+    double* tend_sec = NULL;
+    reprompi_ticks_t* tstart_ticks = NULL;
+    reprompi_ticks_t* tend_ticks = NULL;
+    reprompi_raw_ticks_t raw_ticks;
     reprompib_options_t opts;
     reprompib_sync_options_t sync_opts;
     reprompib_common_options_t common_opts;
@@ -157,6 +680,15 @@ int main(int argc, char* argv[]) {
     time_t start_time, end_time;
     reprompib_sync_functions_t sync_f;
     reprompib_dictionary_t params_dict;
+    sync_window_slack_t get_window_slack;
+    reprompi_timestamp_arena_t arena;
+    long max_nrep, total_nrep, arena_nrep;
+    int print_n_inner;
+    int arena_flags;
+    int arena_status[2];
+    long n_warmup_calls;
+    double* rep_costs = NULL;
+    double budget_start, slice_start, slice_s, remaining_cost, ci_width;
 
     /* start up MPI
      *
@@ -172,8 +704,8 @@ int main(int argc, char* argv[]) {
     //initialize dictionary
     reprompib_init_dictionary(&params_dict, HASHTABLE_SIZE);
 
-    // initialize synchronization functions according to the configured synchronization method
-    initialize_sync_implementation(&sync_f);
+    // initialize synchronization functions according to the selected synchronization method
+    initialize_sync_implementation(argc, argv, &sync_f);
 
     // parse arguments and set-up benchmarking jobs
     print_command_line_args(argc, argv);
@@ -191,63 +723,178 @@ int main(int argc, char* argv[]) {
 
     // parse the arguments related to the synchronization and timing method
     sync_f.parse_sync_params( argc, argv, &sync_opts);
+    sync_opts.output_file = common_opts.output_file;
 
     if (common_opts.input_file == NULL && opts.n_rep <=0) { // make sure nrep is specified when there is no input file
       reprompib_print_error_and_exit("The number of repetitions is not defined (specify the \"--nrep\" command-line argument or provide an input file)\n");
     }
-    generate_job_list(&common_opts, opts.n_rep, &jlist);
+    generate_job_list(&common_opts, opts.n_rep, opts.n_inner, &jlist);
+    print_n_inner = jobs_use_inner_iterations(&jlist);
 
+    // the window slack is only printed on request
+    get_window_slack = opts.sync_diagnostics ? sync_f.get_window_slack : NULL;
 
-    init_collective_basic_info(common_opts, procs, &coll_basic_info);
-    // execute the benchmark jobs
-    for (jindex = 0; jindex < jlist.n_jobs; jindex++) {
-        job_t job;
-        job = jlist.jobs[jlist.job_indices[jindex]];
-
-        // start synchronization module
-        sync_f.init_sync_module(sync_opts, job.n_rep);
+    // measure the overhead of the timer used in the measurement loop on each process
+    if (opts.raw_ticks) {
+        reprompi_calibrate_ticks();
+    } else {
+        reprompi_calibrate_timer(sync_f.get_time);
+    }
 
-        tstart_sec = (double*) malloc(job.n_rep * sizeof(double));
-        tend_sec = (double*) malloc(job.n_rep * sizeof(double));
+    // the rounds are shuffled with the same seed on all processes
+    if (opts.n_rounds > 0 && !opts.seed_set) {
+        opts.seed = (unsigned int) time(NULL);
+        MPI_Bcast(&opts.seed, 1, MPI_UNSIGNED, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+    }
 
-        if (jindex == 0) {
-            print_initial_settings(&opts, &common_opts, sync_f.print_sync_info, &params_dict);
-            print_results_header(&opts, common_opts.output_file, opts.verbose);
+    // the timestamp arrays of all jobs share one arena sized for the largest job
+    // (for all jobs when their repetitions are interleaved),
+    // so that neither allocations nor first-touch page faults happen while measuring
+    max_nrep = 1;
+    total_nrep = 0;
+    for (jindex = 0; jindex < jlist.n_jobs; jindex++) {
+        if (jlist.jobs[jindex].n_rep > max_nrep) {
+            max_nrep = jlist.jobs[jindex].n_rep;
         }
+        total_nrep += jlist.jobs[jindex].n_rep;
+    }
+    arena_nrep = (opts.n_rounds > 0) ? total_nrep : max_nrep;
+    arena_flags = 0;
+    if (opts.lock_memory) {
+        arena_flags |= REPROMPI_ARENA_LOCK;
+    }
+    if (opts.huge_pages) {
+        arena_flags |= REPROMPI_ARENA_HUGE_PAGES;
+    }
+    if (reprompi_arena_init(&arena,
+            2 * arena_nrep * (opts.raw_ticks ? sizeof(reprompi_ticks_t) : sizeof(double)), arena_flags) != 0) {
+        reprompib_print_error_and_exit("Cannot allocate memory for the measurement timestamps");
+    }
+    // locking and huge pages are only reported if they succeeded on all processes
+    arena_status[0] = arena.locked;
+    arena_status[1] = arena.huge_pages;
+    MPI_Allreduce(MPI_IN_PLACE, arena_status, 2, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
 
-        collective_calls[job.call_index].initialize_data(coll_basic_info, job.count, &coll_params);
-
-        // initialize synchronization
-        sync_f.sync_clocks();
-        sync_f.init_sync();
 
-        // execute MPI call nrep times
-        for (i = 0; i < job.n_rep; i++) {
-            sync_f.start_sync();
+    init_collective_basic_info(common_opts, procs, &coll_basic_info);
 
-            tstart_sec[i] = sync_f.get_time();
-            collective_calls[job.call_index].collective_call(&coll_params);
-            tend_sec[i] = sync_f.get_time();
+    // the time budget is split among the jobs according to their cost in a pilot run
+    budget_start = get_time();
+    if (opts.time_budget_s > 0) {
+        rep_costs = (double*) malloc(jlist.n_jobs * sizeof(double));
+        estimate_repetition_costs(&jlist, coll_basic_info,
+                (sync_f.get_start_errors != NULL) ? sync_opts.window_size_sec : 0, rep_costs);
+        alloc_job_sync_results(max_nrep, &sync_f, get_window_slack);
+    }
 
-            sync_f.stop_sync();
+    if (opts.n_rounds > 0) {
+        run_interleaved_jobs(&jlist, coll_basic_info, sync_opts, &sync_f, &opts, &common_opts, &params_dict,
+                &arena, arena_status, get_window_slack);
+    } else {
+        // execute the benchmark jobs
+        for (jindex = 0; jindex < jlist.n_jobs; jindex++) {
+            job_t job;
+            job = jlist.jobs[jlist.job_indices[jindex]];
+
+            // start synchronization module
+            sync_f.init_sync_module(sync_opts, job.n_rep);
+
+            if (opts.raw_ticks) {
+                tstart_ticks = (reprompi_ticks_t*) reprompi_arena_get_array(&arena, 0, max_nrep, sizeof(reprompi_ticks_t));
+                tend_ticks = (reprompi_ticks_t*) reprompi_arena_get_array(&arena, 1, max_nrep, sizeof(reprompi_ticks_t));
+            } else {
+                tstart_sec = (double*) reprompi_arena_get_array(&arena, 0, max_nrep, sizeof(double));
+                tend_sec = (double*) reprompi_arena_get_array(&arena, 1, max_nrep, sizeof(double));
+            }
+
+            if (jindex == 0) {
+                print_initial_settings(&opts, &common_opts, sync_f.print_sync_info, &params_dict,
+                        arena_status[0], arena_status[1]);
+                print_results_header(&opts, common_opts.output_file, opts.verbose, sync_f.get_errorcodes,
+                        sync_f.get_start_errors, get_window_slack, print_n_inner);
+            }
+
+            // the time left is split among the remaining jobs (the root decides)
+            slice_start = get_time();
+            slice_s = 0;
+            ci_width = -1;
+            if (opts.time_budget_s > 0) {
+                remaining_cost = 0;
+                for (i = jindex; i < jlist.n_jobs; i++) {
+                    remaining_cost += rep_costs[jlist.job_indices[i]];
+                }
+                slice_s = opts.time_budget_s - (slice_start - budget_start);
+                if (remaining_cost > 0) {
+                    slice_s = slice_s * rep_costs[jlist.job_indices[jindex]] / remaining_cost;
+                } else {
+                    slice_s = slice_s / (jlist.n_jobs - jindex);
+                }
+                MPI_Bcast(&slice_s, 1, MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+            }
+
+            collective_calls[job.call_index].initialize_data(coll_basic_info, job.count, &coll_params);
+
+            // warm up before the clocks are synchronized, so that it does not add to the clock drift
+            n_warmup_calls = run_warmup(&job, &coll_params, &opts);
+
+            // initialize synchronization
+            sync_f.sync_clocks();
+
+            if (opts.time_budget_s > 0) {
+                // execute MPI call until the time slice is used up or the median is precise enough
+                job.n_rep = measure_with_budget(&job, &coll_params, &sync_f, &opts, slice_start, slice_s,
+                        get_window_slack, tstart_sec, tend_sec, tstart_ticks, tend_ticks, &ci_width);
+            } else {
+                sync_f.init_sync();
+
+                // execute MPI call nrep times
+                measure_repetitions(&job, &coll_params, 0, job.n_rep, &sync_f, opts.raw_ticks,
+                        tstart_sec, tend_sec, tstart_ticks, tend_ticks);
+                if (opts.timer_correction) {
+                    if (opts.raw_ticks) {
+                        subtract_timer_overhead_ticks(job.n_rep, tstart_ticks, tend_ticks);
+                    } else {
+                        subtract_timer_overhead(job.n_rep, tstart_sec, tend_sec);
+                    }
+                }
+            }
+
+            //print summarized data
+            if (opts.warmup_auto) {
+                print_warmup_calls(n_warmup_calls, &common_opts);
+            }
+            raw_ticks.tstart = tstart_ticks;
+            raw_ticks.tend = tend_ticks;
+            raw_ticks.ticks_to_time = sync_f.ticks_to_time;
+            if (opts.time_budget_s > 0) {
+                print_budget_info(slice_s, ci_width, &common_opts);
+                reprompib_print_bench_output(job, tstart_sec, tend_sec, opts.raw_ticks ? &raw_ticks : NULL,
+                        (job_errorcodes != NULL) ? get_job_errorcodes : NULL, sync_f.get_normalized_time,
+                        (job_start_errors != NULL) ? get_job_start_errors : NULL,
+                        (job_window_slack != NULL) ? get_job_window_slack : NULL,
+                        &opts, &common_opts, print_n_inner);
+            } else {
+                reprompib_print_bench_output(job, tstart_sec, tend_sec, opts.raw_ticks ? &raw_ticks : NULL,
+                        sync_f.get_errorcodes, sync_f.get_normalized_time, sync_f.get_start_errors, get_window_slack,
+                        &opts, &common_opts, print_n_inner);
+            }
+
+            tstart_sec = tend_sec = NULL;
+            tstart_ticks = tend_ticks = NULL;
+
+            collective_calls[job.call_index].cleanup_data(&coll_params);
+
+            sync_f.clean_sync_module();
         }
-
-        //print summarized data
-        reprompib_print_bench_output(job, tstart_sec, tend_sec, sync_f.get_errorcodes,
-                sync_f.get_normalized_time, &opts, &common_opts);
-
-        free(tstart_sec);
-        free(tend_sec);
-
-        collective_calls[job.call_index].cleanup_data(&coll_params);
-
-        sync_f.clean_sync_module();
     }
 
 
     end_time = time(NULL);
     print_final_info(&common_opts, start_time, end_time);
 
+    free_job_sync_results();
+    free(rep_costs);
+    reprompi_arena_free(&arena);
     cleanup_job_list(jlist);
     reprompib_free_common_parameters(&common_opts);
     reprompib_free_parameters(&opts);
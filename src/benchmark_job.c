@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <assert.h>
 #include "mpi.h"
 
@@ -43,18 +44,32 @@ void cleanup_job_list(job_list_t jobs) {
   }
 }
 
+int jobs_use_inner_iterations(const job_list_t* jlist) {
+  int i;
+
+  for (i = 0; i < jlist->n_jobs; i++) {
+    if (jlist->jobs[i].n_inner > 1) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
 /*
  * Read jobs from input file into jlist
+ * (one job per line: MPI call, msize, nrep and, optionally, the number of inner iterations)
  *
  */
-void read_input_jobs(char* file_name, job_list_t* jlist) {
+void read_input_jobs(char* file_name, const long predefined_n_inner, job_list_t* jlist) {
   FILE* file;
   int result = 0;
   int expected_result = 0;
   int len_jobs;
+  char line[1024];
   char mpi_call[100];
   size_t msize;
   long nrep;
+  long n_inner;
   int mpi_call_index;
 
   jlist->jobs = (job_t*) calloc(LEN_JOB_BATCH, sizeof(job_t));
@@ -63,16 +78,17 @@ void read_input_jobs(char* file_name, job_list_t* jlist) {
   file = fopen(file_name, "r");
   if (file) {
 
-    while (1) {
-      result = fscanf(file, "%s %zu %ld", mpi_call, &msize, &nrep);
+    while (fgets(line, sizeof(line), file) != NULL) {
+      n_inner = predefined_n_inner;
+      result = sscanf(line, "%99s %zu %ld %ld", mpi_call, &msize, &nrep, &n_inner);
 
-      /* number of job parameters: MPI call, msize, nrep */
+      /* number of job parameters: MPI call, msize, nrep (the inner iterations are optional) */
       expected_result = 3;
 
-      if (result == EOF) {
-        break;
+      if (result == EOF) { /* empty line */
+        continue;
       }
-      if (result != expected_result) /* incorrectly formatted file */
+      if (result < expected_result || n_inner <= 0) /* incorrectly formatted file */
       {
         fprintf(stderr, "ERROR: Incorrectly formatted input file: %s\n", file_name);
         break;
@@ -90,6 +106,7 @@ void read_input_jobs(char* file_name, job_list_t* jlist) {
       jlist->jobs[len_jobs].call_index = mpi_call_index;
       jlist->jobs[len_jobs].msize = msize;
       jlist->jobs[len_jobs].n_rep = nrep;
+      jlist->jobs[len_jobs].n_inner = n_inner;
 
       len_jobs++;
 
@@ -113,7 +130,8 @@ void read_input_jobs(char* file_name, job_list_t* jlist) {
 
 }
 
-void generate_job_list(const reprompib_common_options_t *opts, const int predefined_n_rep, job_list_t* jlist) {
+void generate_job_list(const reprompib_common_options_t *opts, const int predefined_n_rep,
+    const long predefined_n_inner, job_list_t* jlist) {
   int sizeindex, cindex, i;
   int my_rank;
   int datatypesize;
@@ -126,13 +144,14 @@ void generate_job_list(const reprompib_common_options_t *opts, const int predefi
 
   /* read jobs from input file and ignore other options */
   if (opts->input_file != NULL) {
-    MPI_Datatype basetypes[] = { MPI_INT, MPI_AINT, MPI_AINT, MPI_LONG};
-    int blocks[] =  { 1, 1, 1, 1 };
-    MPI_Aint disp[] = {0, sizeof(int), sizeof(size_t) + sizeof(int), 2 *sizeof(size_t) + sizeof(int)};
-    MPI_Datatype job_info_dt;
+    MPI_Datatype basetypes[] = { MPI_INT, MPI_AINT, MPI_AINT, MPI_LONG, MPI_LONG};
+    int blocks[] =  { 1, 1, 1, 1, 1 };
+    MPI_Aint disp[] = { offsetof(job_t, call_index), offsetof(job_t, count), offsetof(job_t, msize),
+        offsetof(job_t, n_rep), offsetof(job_t, n_inner) };
+    MPI_Datatype job_info_dt, job_info_struct_dt;
 
     if (my_rank == INPUT_ROOT_PROC) {
-      read_input_jobs(opts->input_file, jlist);
+      read_input_jobs(opts->input_file, predefined_n_inner, jlist);
     }
     // send the number of jobs to all processes
     MPI_Bcast(&(jlist->n_jobs), 1, MPI_INT, INPUT_ROOT_PROC, MPI_COMM_WORLD);
@@ -143,8 +162,10 @@ void generate_job_list(const reprompib_common_options_t *opts, const int predefi
       }
 
       // create datatype to hold a job info
-      MPI_Type_create_struct ( 4, blocks, disp, basetypes, &job_info_dt);
+      MPI_Type_create_struct ( 5, blocks, disp, basetypes, &job_info_struct_dt);
+      MPI_Type_create_resized(job_info_struct_dt, 0, sizeof(job_t), &job_info_dt);
       MPI_Type_commit (&job_info_dt);
+      MPI_Type_free(&job_info_struct_dt);
 
       // broadcast the job list to all processes
       MPI_Bcast(jlist->jobs, jlist->n_jobs, job_info_dt, INPUT_ROOT_PROC, MPI_COMM_WORLD);
@@ -167,6 +188,7 @@ void generate_job_list(const reprompib_common_options_t *opts, const int predefi
           jlist->jobs[i].msize = opts->msize_list[sizeindex];
           jlist->jobs[i].call_index = opts->list_mpi_calls[cindex];
           jlist->jobs[i].n_rep = predefined_n_rep;
+          jlist->jobs[i].n_inner = predefined_n_inner;
 
           i++;
         }
@@ -218,3 +240,61 @@ void generate_job_list(const reprompib_common_options_t *opts, const int predefi
   }
 }
 
+
+/*
+ * Split each job into (at most) n_rounds_per_job rounds of consecutive repetitions
+ * and shuffle the rounds of all jobs
+ *
+ */
+void generate_round_schedule(const job_list_t* jlist, const long n_rounds_per_job, const unsigned int seed,
+    job_schedule_t* schedule) {
+  int i, j, k;
+  int my_rank;
+  long n_rounds;
+  job_round_t* rounds;
+  int* order;
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+  schedule->n_rounds = 0;
+  for (j = 0; j < jlist->n_jobs; j++) {
+    n_rounds = (jlist->jobs[j].n_rep < n_rounds_per_job) ? jlist->jobs[j].n_rep : n_rounds_per_job;
+    schedule->n_rounds += n_rounds;
+  }
+
+  rounds = (job_round_t*) malloc(schedule->n_rounds * sizeof(job_round_t));
+  i = 0;
+  for (j = 0; j < jlist->n_jobs; j++) {
+    n_rounds = (jlist->jobs[j].n_rep < n_rounds_per_job) ? jlist->jobs[j].n_rep : n_rounds_per_job;
+    for (k = 0; k < n_rounds; k++) {
+      rounds[i].job_index = j;
+      rounds[i].first_rep = k * jlist->jobs[j].n_rep / n_rounds;
+      rounds[i].n_rep = (k + 1) * jlist->jobs[j].n_rep / n_rounds - rounds[i].first_rep;
+      i++;
+    }
+  }
+
+  // the root decides on the order, so that all processes execute the same schedule
+  order = (int*) malloc(schedule->n_rounds * sizeof(int));
+  if (my_rank == OUTPUT_ROOT_PROC) {
+    for (i = 0; i < schedule->n_rounds; i++) {
+      order[i] = i;
+    }
+    shuffle_with_seed(order, schedule->n_rounds, seed);
+  }
+  MPI_Bcast(order, schedule->n_rounds, MPI_INT, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+
+  schedule->rounds = (job_round_t*) malloc(schedule->n_rounds * sizeof(job_round_t));
+  for (i = 0; i < schedule->n_rounds; i++) {
+    schedule->rounds[i] = rounds[order[i]];
+  }
+
+  free(order);
+  free(rounds);
+}
+
+void cleanup_round_schedule(job_schedule_t* schedule) {
+  free(schedule->rounds);
+  schedule->rounds = NULL;
+  schedule->n_rounds = 0;
+}
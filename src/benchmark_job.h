@@ -31,6 +31,7 @@ typedef struct {
     size_t count;
     size_t msize;
     long n_rep;
+    long n_inner; /* number of calls measured together in one repetition */
 } job_t;
 
 typedef struct {
@@ -41,7 +42,26 @@ typedef struct {
 
 } job_list_t;
 
-void generate_job_list(const reprompib_common_options_t *opts, const int predefined_n_rep, job_list_t* jlist);
+/* a contiguous range of repetitions of one job */
+typedef struct {
+    int job_index; /* index in the list of jobs */
+    long first_rep;
+    long n_rep;
+} job_round_t;
+
+typedef struct {
+    job_round_t* rounds; /* rounds of all jobs in execution order */
+    int n_rounds;
+} job_schedule_t;
+
+void generate_job_list(const reprompib_common_options_t *opts, const int predefined_n_rep,
+    const long predefined_n_inner, job_list_t* jlist);
 void cleanup_job_list(job_list_t jobs);
+/* returns 1 if at least one job measures more than one call per repetition */
+int jobs_use_inner_iterations(const job_list_t* jlist);
+
+void generate_round_schedule(const job_list_t* jlist, const long n_rounds_per_job, const unsigned int seed,
+    job_schedule_t* schedule);
+void cleanup_round_schedule(job_schedule_t* schedule);
 
 #endif /* BENCHMARK_JOB_H_ */
@@ -28,7 +28,7 @@
 #include <limits.h>
 #include "mpi.h"
 #include "reprompi_bench/option_parser/parse_common_options.h"
-#include "reprompi_bench/sync/benchmark_barrier_sync/bbarrier_sync.h"
+#include "reprompi_bench/sync/benchmark_barrier_sync/bbarrier_algorithms.h"
 #include "buf_manager/mem_allocation.h"
 #include "collectives.h"
 
@@ -216,7 +216,7 @@ const collective_ops_t collective_calls[] = {
         [BBARRIER] = {
                 &execute_BBarrier,
                 &initialize_data_default,
-                &cleanup_data_default
+                &cleanup_data_BBarrier
         },
         [EMPTY] = {
                 &execute_Empty,
@@ -299,7 +299,7 @@ char* get_call_from_index(int index) {
 
 
 inline void execute_BBarrier(collective_params_t* params) {
-    dissemination_barrier();
+    reprompi_bbarrier();
 }
 
 
@@ -336,6 +336,12 @@ void cleanup_data_default(collective_params_t* params) {
 }
 
 
+void cleanup_data_BBarrier(collective_params_t* params) {
+    cleanup_data_default(params);
+    reprompi_bbarrier_free();
+}
+
+
 void initialize_common_data(const basic_collective_params_t info,
         collective_params_t* params) {
 
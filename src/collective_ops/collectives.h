@@ -206,6 +206,7 @@ void initialize_data_pingpong(const basic_collective_params_t info, const long c
 
 // buffer cleanup functions
 void cleanup_data_default(collective_params_t* params);
+void cleanup_data_BBarrier(collective_params_t* params);
 
 
 void cleanup_data_Allgather(collective_params_t* params);
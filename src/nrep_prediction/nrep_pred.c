@@ -32,6 +32,7 @@
 #include <gsl/gsl_statistics.h>
 #include <gsl/gsl_sort.h>
 
+#include "reprompi_bench/misc.h"
 #include "reprompi_bench/option_parser/parse_common_options.h"
 #include "reprompi_bench/option_parser/parse_extra_key_value_options.h"
 #include "reprompi_bench/sync/synchronization.h"
@@ -41,8 +42,6 @@
 #include "benchmark_job.h"
 #include "parse_nrep_pred_options.h"
 
-#ifndef ENABLE_WINDOWSYNC
-
 static const int OUTPUT_ROOT_PROC = 0;
 static const int HASHTABLE_SIZE=100;
 
@@ -163,11 +162,8 @@ void nrep_pred_print_results_header(const char* filename) {
     }
   }
 }
-#endif
 
 int main(int argc, char* argv[]) {
-
-#ifndef ENABLE_WINDOWSYNC
   int my_rank, procs;
   long i, jindex, current_index;
   double* tstart_sec;
@@ -211,11 +207,17 @@ int main(int argc, char* argv[]) {
   // parse extra parameters into the global dictionary
   reprompib_parse_extra_key_value_options(&params_dict, argc, argv);
 
-  // initialize synchronization functions according to the configured synchronization method
-  initialize_sync_implementation(&sync_f);
+  // initialize synchronization functions according to the selected synchronization method
+  initialize_sync_implementation(argc, argv, &sync_f);
+  if (sync_f.get_errorcodes != NULL) {
+    reprompib_print_error_and_exit("Cannot use this NREP prediction module with window-based synchronization or global times "
+        "(use --sync=MPI_Barrier or --sync=BBarrier)");
+  }
 
   // start synchronization module
   sync_f.parse_sync_params(argc, argv, &sync_opts);
+  // measure the overhead of the timer used in the measurement loop on each process
+  reprompi_calibrate_timer(sync_f.get_time);
   sync_f.init_sync_module(sync_opts, pred_params.max_nrep);
 
   max_nreps = 0;
@@ -227,7 +229,7 @@ int main(int argc, char* argv[]) {
   }
 
   // generate list of jobs ((mpifunc, count) tuples) with nrep=0 for each of them
-  generate_job_list(&opts, 0, &jlist);
+  generate_job_list(&opts, 0, 1, &jlist);
 
   init_collective_basic_info(opts, procs, &coll_basic_info);
 
@@ -336,10 +338,5 @@ int main(int argc, char* argv[]) {
   /* shut down MPI */
   MPI_Finalize();
 
-#else
-  printf("ERROR: Cannot use this NREP prediction module with window-based synchronization. \n");
-  printf("Please disable the HCA, SKaMPI or JK synchronization compile flags and use either the MPI_Barrier (default) or the dissemination barrier (ENABLE_BENCHMARK_BARRIER flag) for process synchronization.\n");
-#endif
-
   return 0;
 }
@@ -147,15 +147,13 @@ void compute_runtimes(double* tstart_sec, double* tend_sec, long current_start_i
     sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time, double* maxRuntimes_sec, long* updated_nreps) {
 
   int my_rank;
-
-  MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-
-#ifdef ENABLE_WINDOWSYNC
   int* sync_errorcodes;
   int i;
 
+  MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
   sync_errorcodes = NULL;
-  if (my_rank == OUTPUT_ROOT_PROC) {
+  if (my_rank == OUTPUT_ROOT_PROC && get_errorcodes != NULL) {
 
     sync_errorcodes = (int*) malloc(current_nreps * sizeof(int));
     for (i = 0; i < current_nreps; i++) {
@@ -163,42 +161,37 @@ void compute_runtimes(double* tstart_sec, double* tend_sec, long current_start_i
     }
   }
 
-  compute_runtimes_global_clocks(tstart_sec, tend_sec,
+  compute_runtimes_by_sync_method(tstart_sec, tend_sec,
       current_start_index, current_nreps, OUTPUT_ROOT_PROC,
       get_errorcodes, get_global_time,
       maxRuntimes_sec, sync_errorcodes);
 
-#else
-  compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, current_nreps, OUTPUT_ROOT_PROC,
-      maxRuntimes_sec);
-#endif
-
-#if defined (ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
+  if (get_errorcodes != NULL) {   // measurements with window-based synchronization
 
-  // remove measurements that resulted in an window error
-  long nreps = 0;
+    // remove measurements that resulted in an window error
+    long nreps = 0;
 
-  if (my_rank == OUTPUT_ROOT_PROC) {
-    for (i = 0; i < current_nreps; i++) {
-      //printf("i=%d nrep=%d error=%d\n", i, nreps, sync_errorcodes[i]);
+    if (my_rank == OUTPUT_ROOT_PROC) {
+      for (i = 0; i < current_nreps; i++) {
+        //printf("i=%d nrep=%d error=%d\n", i, nreps, sync_errorcodes[i]);
 
-      if (sync_errorcodes[i] == 0) {
-        if (nreps < i) {
-          //printf("\t\t maxRuntimes_sec[%d]=maxRuntimes_sec[%d] \n", nreps, i );
-          maxRuntimes_sec[nreps] = maxRuntimes_sec[i];
+        if (sync_errorcodes[i] == 0) {
+          if (nreps < i) {
+            //printf("\t\t maxRuntimes_sec[%d]=maxRuntimes_sec[%d] \n", nreps, i );
+            maxRuntimes_sec[nreps] = maxRuntimes_sec[i];
+          }
+          nreps++;
         }
-        nreps++;
       }
-    }
 
-    free(sync_errorcodes);
-  }
+      free(sync_errorcodes);
+    }
 
-  *updated_nreps = nreps;
+    *updated_nreps = nreps;
 
-#else // measurements with Barrier-based synchronization
-  *updated_nreps = current_nreps;
-#endif
+  } else { // measurements with Barrier-based synchronization
+    *updated_nreps = current_nreps;
+  }
 
 }
 
@@ -237,8 +230,8 @@ int main(int argc, char* argv[]) {
   // initialize global dictionary
   reprompib_init_dictionary(&params_dict, HASHTABLE_SIZE);
 
-  // initialize synchronization functions according to the configured synchronization method
-  initialize_sync_implementation(&sync_f);
+  // initialize synchronization functions according to the selected synchronization method
+  initialize_sync_implementation(argc, argv, &sync_f);
 
   // parse arguments and set-up benchmarking jobs
   print_command_line_args(argc, argv);
@@ -253,10 +246,14 @@ int main(int argc, char* argv[]) {
   reprompib_parse_extra_key_value_options(&params_dict, argc, argv);
 
   sync_f.parse_sync_params(argc, argv, &sync_opts);
+  sync_opts.output_file = common_opt.output_file;
+
+  // measure the overhead of the timer used in the measurement loop on each process
+  reprompi_calibrate_timer(sync_f.get_time);
 
   init_collective_basic_info(common_opt, procs, &coll_basic_info);
   //generate_pred_job_list(&pred_opts, &common_opt, &jlist);
-  generate_job_list(&common_opt, 0, &jlist);
+  generate_job_list(&common_opt, 0, 1, &jlist);
 
   // execute the benchmark jobs
   for (jindex = 0; jindex < jlist.n_jobs; jindex++) {
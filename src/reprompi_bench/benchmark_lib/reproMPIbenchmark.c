@@ -51,6 +51,7 @@ void print_initial_settings(long nrep, print_sync_info_t print_sync_info) {
   MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
   MPI_Comm_size(MPI_COMM_WORLD, &np);
 
+  gather_time_parameters();
   if (my_rank == OUTPUT_ROOT_PROC) {
     fprintf(f, "#@nrep=%ld\n", nrep);
     print_common_settings_to_file(f, print_sync_info, &params_dict);
@@ -69,7 +70,7 @@ void reprompib_print_bench_output(const reprompib_job_t* job_p,
 
   if (first_print_call) {
     print_initial_settings(opts->n_rep, sync_f->print_sync_info);
-    print_results_header(&output_info, job_p);
+    print_results_header(&output_info, job_p, sync_f->get_errorcodes);
     first_print_call = 0;
   }
 
@@ -103,8 +104,8 @@ void reprompib_initialize_benchmark(int argc, char* argv[], reprompib_sync_funct
   // parse the benchmark-specific arguments (nreps, summary)
   reprompib_parse_options(opts_p, argc, argv);
 
-  // initialize synchronization functions according to the configured synchronization method
-  initialize_sync_implementation(sync_f_p);
+  // initialize synchronization functions according to the selected synchronization method
+  initialize_sync_implementation(argc, argv, sync_f_p);
 
   sync_f_p->parse_sync_params(argc, argv, &sync_opts);
 
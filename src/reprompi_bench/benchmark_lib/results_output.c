@@ -37,7 +37,7 @@
 static const int OUTPUT_ROOT_PROC = 0;
 
 void print_results_header(const reprompib_lib_output_info_t* output_info_p,
-    const reprompib_job_t* job_p) {
+    const reprompib_job_t* job_p, const sync_errorcodes_t get_errorcodes) {
     FILE* f = stdout;
     int my_rank;
 
@@ -56,15 +56,12 @@ void print_results_header(const reprompib_lib_output_info_t* output_info_p,
         fprintf(f, "%20s %4s", "measure_type", "proc");
 
         if (output_info_p->verbose == 1 && output_info_p->print_summary_methods == 0) {
-#ifdef ENABLE_WINDOWSYNC
-            fprintf(f, " %12s", "errorcode");
-#endif
-
-#ifdef ENABLE_WINDOWSYNC
-            fprintf(f," %8s %16s %16s %16s %16s\n", "nrep", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
-#else
-            fprintf(f," %8s %16s %16s\n",  "nrep", "loc_tstart_sec", "loc_tend_sec");
-#endif
+            if (get_errorcodes != NULL) {
+                fprintf(f, " %12s", "errorcode");
+                fprintf(f," %8s %16s %16s %16s %16s\n", "nrep", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
+            } else {
+                fprintf(f," %8s %16s %16s\n",  "nrep", "loc_tstart_sec", "loc_tend_sec");
+            }
         } else {
 
             // print summary
@@ -80,9 +77,9 @@ void print_results_header(const reprompib_lib_output_info_t* output_info_p,
               fprintf(f, "\n");
             }
             else {
-#ifdef ENABLE_WINDOWSYNC
-                fprintf(f, " %12s", "errorcode");
-#endif
+                if (get_errorcodes != NULL) {
+                    fprintf(f, " %12s", "errorcode");
+                }
                 fprintf(f, " %8s %16s\n", "nrep", "runtime_sec");
             }
         }
@@ -150,24 +147,24 @@ void print_runtimes(FILE* f, const reprompib_job_t* job_p,
     if (my_rank == OUTPUT_ROOT_PROC) {
         maxRuntimes_sec = (double*) malloc(job_p->n_rep * sizeof(double));
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job_p->n_rep * sizeof(int));
-        for (i = 0; i < job_p->n_rep; i++) {
-            sync_errorcodes[i] = 0;
+        if (get_errorcodes != NULL) {
+            sync_errorcodes = (int*) malloc(job_p->n_rep * sizeof(int));
+            for (i = 0; i < job_p->n_rep; i++) {
+                sync_errorcodes[i] = 0;
+            }
         }
-#endif
     }
 
     current_start_index = 0;
 
-#ifdef ENABLE_WINDOWSYNC
-    compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
-            get_errorcodes, get_global_time,
-            maxRuntimes_sec, sync_errorcodes);
-#else
-    compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
-            maxRuntimes_sec, job_p->op);
-#endif
+    if (get_errorcodes != NULL) {
+        compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    } else {
+        compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
+                maxRuntimes_sec, job_p->op);
+    }
 
     if (my_rank == OUTPUT_ROOT_PROC) {
         for (i = 0; i < job_p->n_rep; i++) {
@@ -180,19 +177,17 @@ void print_runtimes(FILE* f, const reprompib_job_t* job_p,
                 fprintf(f, "%10d ", job_p->user_ivars[j]);
             }
 
-#if defined(ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-            fprintf(f, "%20s %4s %12d %8d %16.10f\n", job_p->timername, "all",
-                    sync_errorcodes[i],i,
-                    maxRuntimes_sec[i]);
-#else   // measurements with Barrier-based synchronization
-            fprintf(f, "%20s %4s %8d %16.10f\n", job_p->timername, "all",
-                    i, maxRuntimes_sec[i]);
-#endif
+            if (get_errorcodes != NULL) {   // measurements with window-based synchronization
+                fprintf(f, "%20s %4s %12d %8d %16.10f\n", job_p->timername, "all",
+                        sync_errorcodes[i],i,
+                        maxRuntimes_sec[i]);
+            } else {   // measurements with Barrier-based synchronization
+                fprintf(f, "%20s %4s %8d %16.10f\n", job_p->timername, "all",
+                        i, maxRuntimes_sec[i]);
+            }
         }
 
-#ifdef ENABLE_WINDOWSYNC
         free(sync_errorcodes);
-#endif
 
         free(maxRuntimes_sec);
     }
@@ -235,14 +230,14 @@ void print_runtimes_allprocs(FILE* f, const reprompib_job_t* job_p,
                     fprintf(f, "%10d ", job_p->user_ivars[j]);
                 }
 
-#if defined(ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-                fprintf(f, "%20s %4d %12d %8d %16.10f\n", job_p->timername,
-                        proc_id, errorcodes[proc_id * job_p->n_rep + i], i,
-                        maxRuntimes_sec[proc_id * job_p->n_rep + i]);
-#else   // measurements with Barrier-based synchronization
-                fprintf(f, "%20s %4d %8d %16.10f\n", job_p->timername,
-                        proc_id,i, maxRuntimes_sec[proc_id * job_p->n_rep + i]);
-#endif
+                if (errorcodes != NULL) {   // measurements with window-based synchronization
+                    fprintf(f, "%20s %4d %12d %8d %16.10f\n", job_p->timername,
+                            proc_id, errorcodes[proc_id * job_p->n_rep + i], i,
+                            maxRuntimes_sec[proc_id * job_p->n_rep + i]);
+                } else {   // measurements with Barrier-based synchronization
+                    fprintf(f, "%20s %4d %8d %16.10f\n", job_p->timername,
+                            proc_id,i, maxRuntimes_sec[proc_id * job_p->n_rep + i]);
+                }
             }
         }
 
@@ -276,25 +271,21 @@ void print_measurement_results(FILE* f,
     }
     else {
 
-#ifdef ENABLE_WINDOWSYNC
-        if (my_rank == OUTPUT_ROOT_PROC)
-        {
-            errorcodes = (int*)malloc(job_p->n_rep * np * sizeof(int));
-            for (i = 0; i < job_p->n_rep * np; i++) {
-                errorcodes[i] = 0;
-            }
-        }
-
-#ifndef ENABLE_BARRIERSYNC	// gather measurement results
-        {
+        if (get_errorcodes != NULL) {
             int* local_errorcodes = get_errorcodes();
 
+            if (my_rank == OUTPUT_ROOT_PROC)
+            {
+                errorcodes = (int*)malloc(job_p->n_rep * np * sizeof(int));
+                for (i = 0; i < job_p->n_rep * np; i++) {
+                    errorcodes[i] = 0;
+                }
+            }
+
+            // gather measurement results
             MPI_Gather(local_errorcodes, job_p->n_rep, MPI_INT,
                     errorcodes, job_p->n_rep, MPI_INT, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
         }
-#endif
-
-#endif
 
         if (my_rank == OUTPUT_ROOT_PROC) {
             local_start_sec = (double*) malloc(
@@ -349,21 +340,20 @@ void print_measurement_results(FILE* f,
                             fprintf(f, "%10d ", job_p->user_ivars[j]);
                         }
 
-#ifdef ENABLE_WINDOWSYNC
-                        fprintf(f, "%20s %4d %12d %8d %16.10f %16.10f %16.10f %16.10f\n",
-                            job_p->timername, proc_id,
-                                errorcodes[proc_id * job_p->n_rep + i], i,
-                                local_start_sec[proc_id * job_p->n_rep + i],
-                                local_end_sec[proc_id * job_p->n_rep + i],
-                                global_start_sec[proc_id * job_p->n_rep + i],
-                                global_end_sec[proc_id * job_p->n_rep + i]);
-
-#else
-                        fprintf(f, "%20s %4d %8d %16.10f %16.10f\n", job_p->timername,
-                                proc_id, i,
-                                local_start_sec[proc_id * job_p->n_rep + i],
-                                local_end_sec[proc_id * job_p->n_rep + i]);
-#endif
+                        if (get_errorcodes != NULL) {
+                            fprintf(f, "%20s %4d %12d %8d %16.10f %16.10f %16.10f %16.10f\n",
+                                job_p->timername, proc_id,
+                                    errorcodes[proc_id * job_p->n_rep + i], i,
+                                    local_start_sec[proc_id * job_p->n_rep + i],
+                                    local_end_sec[proc_id * job_p->n_rep + i],
+                                    global_start_sec[proc_id * job_p->n_rep + i],
+                                    global_end_sec[proc_id * job_p->n_rep + i]);
+                        } else {
+                            fprintf(f, "%20s %4d %8d %16.10f %16.10f\n", job_p->timername,
+                                    proc_id, i,
+                                    local_start_sec[proc_id * job_p->n_rep + i],
+                                    local_end_sec[proc_id * job_p->n_rep + i]);
+                        }
                     }
                 }
             }
@@ -374,9 +364,7 @@ void print_measurement_results(FILE* f,
             free(local_end_sec);
             free(global_start_sec);
             free(global_end_sec);
-#ifdef ENABLE_WINDOWSYNC
             free(errorcodes);
-#endif
 
         }
 
@@ -406,27 +394,27 @@ void print_summary(FILE* f,
     if (my_rank == OUTPUT_ROOT_PROC) {
         maxRuntimes_sec = (double*) malloc(job_p->n_rep * np * sizeof(double));
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job_p->n_rep * np * sizeof(int));
-        for (i = 0; i < job_p->n_rep * np; i++) {
-            sync_errorcodes[i] = 0;
+        if (get_errorcodes != NULL) {
+            sync_errorcodes = (int*) malloc(job_p->n_rep * np * sizeof(int));
+            for (i = 0; i < job_p->n_rep * np; i++) {
+                sync_errorcodes[i] = 0;
+            }
         }
-#endif
     }
 
     current_start_index = 0;
 
     if (strcmp(job_p->timertype, "all") !=0) { // one runtime for each nrep id (reduced over processes)
 
-#ifdef ENABLE_WINDOWSYNC
-        compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec,
-                current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
-                get_errorcodes, get_global_time,
-                maxRuntimes_sec, sync_errorcodes);
-#else
-        compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
-                maxRuntimes_sec, job_p->op);
-#endif
+        if (get_errorcodes != NULL) {
+            compute_runtimes_global_clocks(job_p->tstart_sec, job_p->tend_sec,
+                    current_start_index, job_p->n_rep, OUTPUT_ROOT_PROC,
+                    get_errorcodes, get_global_time,
+                    maxRuntimes_sec, sync_errorcodes);
+        } else {
+            compute_runtimes_local_clocks_with_reduction(job_p->tstart_sec, job_p->tend_sec, current_start_index, job_p->n_rep,
+                    maxRuntimes_sec, job_p->op);
+        }
         n_results = 1;
 
     }
@@ -438,17 +426,12 @@ void print_summary(FILE* f,
         double* tmp_local_start_sec = NULL;
         double* tmp_local_end_sec = NULL;
 
-#ifdef ENABLE_WINDOWSYNC
-#ifndef ENABLE_BARRIERSYNC  // gather measurement results
-        {
+        if (get_errorcodes != NULL) {  // gather measurement results
             int* local_errorcodes = get_errorcodes();
 
             MPI_Gather(local_errorcodes, job_p->n_rep, MPI_INT,
                     sync_errorcodes, job_p->n_rep, MPI_INT, 0, MPI_COMM_WORLD);
         }
-#endif
-
-#endif
 
         if (my_rank == OUTPUT_ROOT_PROC) {
             local_start_sec = (double*) malloc(
@@ -517,21 +500,21 @@ void print_summary(FILE* f,
             nreps = 0;
 
             current_proc_runtimes = maxRuntimes_sec + (proc * job_p->n_rep);
-            current_error_codes = sync_errorcodes + (proc * job_p->n_rep);
 
             // remove measurements with out-of-window errors
-#ifdef ENABLE_WINDOWSYNC
-            for (i = 0; i < job_p->n_rep; i++) {
-                if (current_error_codes[i] == 0) {
-                    if (nreps < i) {
-                        current_proc_runtimes[nreps] = current_proc_runtimes[i];
+            if (get_errorcodes != NULL) {
+                current_error_codes = sync_errorcodes + (proc * job_p->n_rep);
+                for (i = 0; i < job_p->n_rep; i++) {
+                    if (current_error_codes[i] == 0) {
+                        if (nreps < i) {
+                            current_proc_runtimes[nreps] = current_proc_runtimes[i];
+                        }
+                        nreps++;
                     }
-                    nreps++;
                 }
+            } else {
+                nreps = job_p->n_rep;
             }
-#else
-            nreps = job_p->n_rep;
-#endif
 
             gsl_sort(current_proc_runtimes, 1, nreps);
 
@@ -581,9 +564,7 @@ void print_summary(FILE* f,
         }
 
 
-#ifdef ENABLE_WINDOWSYNC
         free(sync_errorcodes);
-#endif
 
         free(maxRuntimes_sec);
     }
@@ -34,7 +34,8 @@ typedef struct {
 } reprompib_lib_output_info_t;
 
 
-void print_results_header(const reprompib_lib_output_info_t* output_info_p, const reprompib_job_t* job_p);
+void print_results_header(const reprompib_lib_output_info_t* output_info_p, const reprompib_job_t* job_p,
+    const sync_errorcodes_t get_errorcodes);
 
 void print_measurement_results(FILE* f,
     const reprompib_lib_output_info_t* output_info_p,
@@ -51,7 +51,11 @@ double repro_max(double a, double b) {
 
 
 void shuffle(int *array, size_t n) {
-    srand(time(NULL));
+    shuffle_with_seed(array, n, time(NULL));
+}
+
+void shuffle_with_seed(int *array, size_t n, unsigned int seed) {
+    srand(seed);
 
     if (n > 1) {
         size_t i;
@@ -29,6 +29,7 @@
 double repro_min(double a, double b);
 double repro_max(double a, double b);
 void shuffle(int *array, size_t n);
+void shuffle_with_seed(int *array, size_t n, unsigned int seed);
 
 int reprompib_str_to_long(const char *str, long* result);
 void reprompib_print_error_and_exit(const char* error_str);
@@ -77,17 +77,70 @@ void reprompib_print_common_help(void) {
                 "", "MPI_Scatter, MPI_Reduce, MPI_Allreduce, MPI_Barrier, Send_Recv,",
                 "", "Isend_Recv, Isend_Irecv, Sendrecv\n");
 
+        printf("\nSynchronization options:\n");
+        printf("%-40s %-40s\n %50s%s\n", "--sync=<method>",
+                "process synchronization method (default: selected at compile time)", "",
+                "MPI_Barrier, BBarrier, SKaMPI, JK, HCA, MPI_Barrier_global, BBarrier_global");
+        printf("%-40s %-40s\n %50s%s\n", "--bbarrier=<type>",
+                "software barrier used by BBarrier (synchronization and MPI call)", "",
+                "dissemination (default), tournament, butterfly, hierarchical");
+        printf("%-40s %-40s\n", "--bbarrier-skew=<nbarriers>",
+                "measure the exit skew of each software barrier over <nbarriers> calls (--sync=BBarrier)");
+        printf("%-40s %-40s\n %50s%s\n", "--clock=<clock>",
+                "clock used for all time measurements (default: selected at compile time)", "",
+                "MPI_Wtime, monotonic, monotonic_raw, realtime, RDTSC, RDTSCP");
+        printf("%-40s %-40s\n", "--sync-free",
+                "run the repetitions back to back, only synchronize the clocks (global times computed afterwards)");
+
         printf("\nWindow-based synchronization options:\n");
         printf("%-40s %-40s\n", "--window-size=<win>",
                 "window size in microseconds for window-based synchronization (default: 1 ms)");
         printf("%-40s %-40s\n", "--wait-time=<wait>",
                 "wait time in microseconds before the start of the first window (default: 1 ms)");
+        printf("%-40s %-40s\n", "--hybrid-wait=<spin>",
+                "sleep until <spin> microseconds before each window, then spin (default: 0, only spin)");
+        printf("%-40s %-40s\n", "--adaptive-window",
+                "size the windows from a pilot run (using --window-size) and adjust them to the error rate");
+        printf("%-40s %-40s\n", "--adaptive-window-pilot=<nwin>",
+                "number of pilot windows (default: 10)");
+        printf("%-40s %-40s\n", "--adaptive-window-batch=<nwin>",
+                "number of windows between two window size adjustments (default: 100)");
+        printf("%-40s %-40s\n", "--node-leader-sync",
+                "synchronize only one leader per node, the other processes use the clock of their leader (not with --clock=MPI_Wtime)");
+        printf("%-40s %-40s\n", "--node-offset-check",
+                "measure the clock offsets between the processes of each node after synchronization");
+        printf("%-40s %-40s\n", "--sync-check=<nprocs>",
+                "measure the global clock offsets of <nprocs> processes to the root after each job (default: 0, no check)");
 
         printf("\nSpecific options for the linear model of the clock skew:\n");
         printf("%-40s %-40s\n", "--fitpoints=<nfit>",
                 "number of fitpoints (default: 20)");
         printf("%-40s %-40s\n", "--exchanges=<nexc>",
-                "number of exchanges (default: 10)\n");
+                "number of exchanges (default: 10)");
+        printf("%-40s %-40s\n", "--sync-model-cache",
+                "reuse the clock models across jobs while they are within the tolerance (HCA, JK)");
+        printf("%-40s %-40s\n", "--sync-model-tolerance=<tol>",
+                "maximum offset to the root in microseconds for reusing a clock model (default: 10)");
+        printf("%-40s %-40s\n", "--sync-model-file=<path>",
+                "save the clock models to <path> and load them in later runs on the same hosts (HCA, JK)");
+        printf("%-40s %-40s\n %50s%s\n", "--hca-topology=<topology>",
+                "communication pattern used by HCA to learn the clock models", "",
+                "linear, binomial or hierarchical");
+        printf("%-40s %-40s\n %50s%s\n", "--sk-topology=<topology>",
+                "communication pattern used by SKaMPI to measure the clock offsets", "",
+                "linear or binomial");
+        printf("%-40s %-40s\n", "--hca-resync-windows=<nwin>",
+                "update the HCA clock models every <nwin> windows (default: 0, no updates)");
+        printf("%-40s %-40s\n", "--hca-resync-time=<sec>",
+                "update the HCA clock models every <sec> seconds of global time (default: 0, no updates)");
+        printf("%-40s %-40s\n %50s%s\n", "--hca-drift-model=<model>",
+                "model fitted to the HCA clock offsets (default: linear)", "",
+                "linear, theilsen, quadratic, piecewise, ransac or auto");
+        printf("%-40s %-40s\n %50s%s\n", "--hca-offset-estimator=<estimator>",
+                "offset estimated from the exchanges of each HCA fit point (default: median)", "",
+                "median, minrtt or huber");
+        printf("%-40s %-40s\n", "--hca-offset-ci=<ci>",
+                "stop the exchanges of a fit point once the offset is known within +/-<ci> microseconds\n");
 
     }
 }
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <string.h>
+#include <limits.h>
 #include "mpi.h"
 
 #include "reprompi_bench/misc.h"
@@ -57,13 +58,35 @@ static summary_method_info_t summary_methods[] = {
 enum reprompi_common_getopt_ids {
   REPROMPI_ARGS_VERBOSE = 'v',
   REPROMPI_ARGS_NREPS = 500,
-  REPROMPI_ARGS_SUMMARY
+  REPROMPI_ARGS_SUMMARY,
+  REPROMPI_ARGS_RAW_TICKS,
+  REPROMPI_ARGS_TIMER_CORRECTION,
+  REPROMPI_ARGS_SYNC_DIAGNOSTICS,
+  REPROMPI_ARGS_LOCK_MEMORY,
+  REPROMPI_ARGS_HUGE_PAGES,
+  REPROMPI_ARGS_INNER_ITERATIONS,
+  REPROMPI_ARGS_WARMUP,
+  REPROMPI_ARGS_INTERLEAVE_ROUNDS,
+  REPROMPI_ARGS_SEED,
+  REPROMPI_ARGS_TIME_BUDGET,
+  REPROMPI_ARGS_CI_WIDTH
 };
 
 static const struct option reprompi_default_long_options[] = {
         {"verbose", optional_argument, 0, REPROMPI_ARGS_VERBOSE},
         { "nrep", required_argument, 0, REPROMPI_ARGS_NREPS },
         {"summary", optional_argument, 0, REPROMPI_ARGS_SUMMARY},
+        {"raw-ticks", no_argument, 0, REPROMPI_ARGS_RAW_TICKS},
+        {"timer-correction", no_argument, 0, REPROMPI_ARGS_TIMER_CORRECTION},
+        {"sync-diagnostics", no_argument, 0, REPROMPI_ARGS_SYNC_DIAGNOSTICS},
+        {"lock-memory", no_argument, 0, REPROMPI_ARGS_LOCK_MEMORY},
+        {"huge-pages", no_argument, 0, REPROMPI_ARGS_HUGE_PAGES},
+        {"inner-iterations", required_argument, 0, REPROMPI_ARGS_INNER_ITERATIONS},
+        {"warmup", required_argument, 0, REPROMPI_ARGS_WARMUP},
+        {"interleave-rounds", required_argument, 0, REPROMPI_ARGS_INTERLEAVE_ROUNDS},
+        {"seed", required_argument, 0, REPROMPI_ARGS_SEED},
+        {"time-budget", required_argument, 0, REPROMPI_ARGS_TIME_BUDGET},
+        {"ci-width", required_argument, 0, REPROMPI_ARGS_CI_WIDTH},
 
         { 0, 0, 0, 0 }
 };
@@ -87,7 +110,20 @@ int reprompib_get_number_summary_methods(void) {
 static void init_parameters(reprompib_options_t* opts_p) {
     opts_p->verbose = 0;
     opts_p->n_rep = 0;
+    opts_p->n_inner = 1;
+    opts_p->n_warmup = 0;
+    opts_p->warmup_auto = 0;
+    opts_p->n_rounds = 0;
+    opts_p->seed = 0;
+    opts_p->seed_set = 0;
+    opts_p->time_budget_s = 0;
+    opts_p->ci_width = 0.05;
     opts_p->print_summary_methods = 0;
+    opts_p->raw_ticks = 0;
+    opts_p->timer_correction = 0;
+    opts_p->sync_diagnostics = 0;
+    opts_p->lock_memory = 0;
+    opts_p->huge_pages = 0;
 }
 
 void reprompib_free_parameters(reprompib_options_t* opts_p) {
@@ -119,7 +155,7 @@ static void parse_summary_list(char* subopts, reprompib_options_t* opts_p) {
 
 void reprompib_parse_options(reprompib_options_t* opts_p, int argc, char** argv) {
     int c, err;
-    long nreps;
+    long nreps, n_inner, n_warmup, n_rounds, seed;
 
     init_parameters(opts_p);
     opterr = 0;
@@ -146,6 +182,58 @@ void reprompib_parse_options(reprompib_options_t* opts_p, int argc, char** argv)
             opts_p->n_rep = nreps;
             break;
 
+        case REPROMPI_ARGS_INNER_ITERATIONS: /* number of calls measured together in each repetition */
+            err = reprompib_str_to_long(optarg, &n_inner);
+            if (err || n_inner <= 0) {
+              reprompib_print_error_and_exit("The number of inner iterations is not positive or not correctly specified");
+            }
+            opts_p->n_inner = n_inner;
+            break;
+
+        case REPROMPI_ARGS_WARMUP: /* number of untimed calls before each job or "auto" */
+            if (strcmp(optarg, "auto") == 0) {
+              opts_p->warmup_auto = 1;
+            } else {
+              err = reprompib_str_to_long(optarg, &n_warmup);
+              if (err || n_warmup < 0) {
+                reprompib_print_error_and_exit("Invalid number of warm-up calls (--warmup=<n>|auto)");
+              }
+              opts_p->n_warmup = n_warmup;
+              opts_p->warmup_auto = 0;
+            }
+            break;
+
+        case REPROMPI_ARGS_INTERLEAVE_ROUNDS: /* split each job into rounds and interleave the rounds of all jobs */
+            err = reprompib_str_to_long(optarg, &n_rounds);
+            if (err || n_rounds <= 0) {
+              reprompib_print_error_and_exit("The number of rounds is not positive or not correctly specified");
+            }
+            opts_p->n_rounds = n_rounds;
+            break;
+
+        case REPROMPI_ARGS_SEED: /* seed for the order of the rounds */
+            err = reprompib_str_to_long(optarg, &seed);
+            if (err || seed < 0 || seed > UINT_MAX) {
+              reprompib_print_error_and_exit("Invalid seed (--seed=<non-negative integer>)");
+            }
+            opts_p->seed = (unsigned int) seed;
+            opts_p->seed_set = 1;
+            break;
+
+        case REPROMPI_ARGS_TIME_BUDGET: /* total time for all jobs in seconds */
+            opts_p->time_budget_s = atof(optarg);
+            if (opts_p->time_budget_s <= 0) {
+              reprompib_print_error_and_exit("The time budget is not positive or not correctly specified (--time-budget=<seconds>)");
+            }
+            break;
+
+        case REPROMPI_ARGS_CI_WIDTH: /* target width of the confidence interval of the median */
+            opts_p->ci_width = atof(optarg);
+            if (opts_p->ci_width < 0) {
+              reprompib_print_error_and_exit("Invalid confidence interval width (--ci-width=<relative width>)");
+            }
+            break;
+
         case REPROMPI_ARGS_SUMMARY: /* list of summary options */
             parse_summary_list(optarg, opts_p);
             break;
@@ -154,12 +242,32 @@ void reprompib_parse_options(reprompib_options_t* opts_p, int argc, char** argv)
         case REPROMPI_ARGS_VERBOSE: /* verbose flag */
             opts_p->verbose = 1;
             break;
+
+        case REPROMPI_ARGS_RAW_TICKS: /* store raw timer ticks in the measurement loop */
+            opts_p->raw_ticks = 1;
+            break;
+        case REPROMPI_ARGS_TIMER_CORRECTION: /* subtract the timer overhead from the runtimes */
+            opts_p->timer_correction = 1;
+            break;
+        case REPROMPI_ARGS_SYNC_DIAGNOSTICS: /* print the window slack of each repetition */
+            opts_p->sync_diagnostics = 1;
+            break;
+        case REPROMPI_ARGS_LOCK_MEMORY: /* mlock the timestamp arrays */
+            opts_p->lock_memory = 1;
+            break;
+        case REPROMPI_ARGS_HUGE_PAGES: /* back the timestamp arrays with huge pages */
+            opts_p->huge_pages = 1;
+            break;
         case '?':
             break;
         }
     }
 
 
+    if (opts_p->time_budget_s > 0 && opts_p->n_rounds > 0) {
+      reprompib_print_error_and_exit("The time budget cannot be combined with interleaved rounds (--interleave-rounds)");
+    }
+
 //    if (opts_p->n_rep < 0) {
 //      reprompib_print_error_and_exit("Nreps value is negative or not correctly specified");
 ///    }
@@ -184,9 +292,36 @@ void reprompib_print_benchmark_help(void) {
         printf("\nSpecific options for the benchmark execution:\n");
         printf("%-40s %-40s\n", "--nrep=<nrep>",
                 "set number of experiment repetitions");
+        printf("%-40s %-40s\n %50s%s\n", "--inner-iterations=<K>",
+                "call the MPI function K times in each repetition and report the mean runtime per call", "",
+                "(a fourth column in the input file sets K per job)");
+        printf("%-40s %-40s\n %50s%s\n", "--warmup=<n>|auto",
+                "call the MPI function n times before each job without measuring it", "",
+                "(auto: until the median runtime of consecutive blocks of calls is stable)");
+        printf("%-40s %-40s\n %50s%s\n", "--interleave-rounds=<R>",
+                "split the repetitions of each job into R rounds and run the rounds of all jobs in random order", "",
+                "(results are merged per job)");
+        printf("%-40s %-40s\n", "--seed=<seed>",
+                "seed for the order of the rounds (default: current time)");
+        printf("%-40s %-40s\n %50s%s\n", "--time-budget=<seconds>",
+                "split the time among the jobs according to a short pilot run and stop each job when", "",
+                "its time is used up, its median is precise enough or it reached nrep repetitions");
+        printf("%-40s %-40s\n %50s%s\n", "--ci-width=<width>",
+                "stop a job of a time-budgeted run when the 95% confidence interval of the median runtime", "",
+                "is narrower than width times the median (default: 0.05, 0 to disable)");
         printf("%-40s %-40s\n %50s%s\n", "--summary=<args>",
                 "list of comma-separated data summarizing methods (mean, median, min, max)", "",
                 "e.g., --summary=mean,max");
+        printf("%-40s %-40s\n", "--raw-ticks",
+                "store raw timer ticks during the measurements and convert them to seconds afterwards");
+        printf("%-40s %-40s\n", "--timer-correction",
+                "subtract the timer overhead measured at startup by each process from its runtimes");
+        printf("%-40s %-40s\n", "--sync-diagnostics",
+                "add the time left in the window after each repetition (window-based synchronization)");
+        printf("%-40s %-40s\n", "--lock-memory",
+                "lock the timestamp arrays in memory (mlock)");
+        printf("%-40s %-40s\n", "--huge-pages",
+                "back the timestamp arrays with huge pages if available");
 
         printf("\nEXAMPLES: mpirun -np 4 ./bin/mpibenchmark --calls-list=MPI_Bcast --msizes-list=8,512,1024 --nrep=5 --summary=mean,max,min\n");
         printf("\n          mpirun -np 4 ./bin/mpibenchmark --calls-list=MPI_Bcast --msizes-list=8,512,1024 --nrep=5\n");
@@ -26,8 +26,21 @@
 
 typedef struct reprompib_opt {
     long n_rep; /* --nrep */
+    long n_inner; /* --inner-iterations */
+    long n_warmup; /* --warmup=<n> */
+    int warmup_auto; /* --warmup=auto */
+    long n_rounds; /* --interleave-rounds */
+    unsigned int seed; /* --seed */
+    int seed_set;
+    double time_budget_s; /* --time-budget */
+    double ci_width; /* --ci-width */
     int verbose; /* -v */
     int print_summary_methods; /* --summary */
+    int raw_ticks; /* --raw-ticks */
+    int timer_correction; /* --timer-correction */
+    int sync_diagnostics; /* --sync-diagnostics */
+    int lock_memory; /* --lock-memory */
+    int huge_pages; /* --huge-pages */
 } reprompib_options_t;
 
 
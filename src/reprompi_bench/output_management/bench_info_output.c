@@ -78,20 +78,8 @@ void print_common_settings_to_file(FILE* f, const print_sync_info_t print_sync_i
 
         fprintf(f, "#@reproMPIcommitSHA1=%s\n", git_commit);
         fprintf(f, "#@nprocs=%d\n", np);
-#ifdef ENABLE_GLOBAL_TIMES
-        fprintf(f, "#@clocktype=global\n");
-#ifdef ENABLE_LOGP_SYNC
-        fprintf(f, "#@hcasynctype=logp\n");
-#else
-        fprintf(f, "#@hcasynctype=linear\n");
-#endif
-#elif defined(ENABLE_WINDOWSYNC)
-        fprintf(f, "#@clocktype=global\n");
-#else
-        fprintf(f, "#@clocktype=local\n");
-#endif
-        print_time_parameters(f);
         print_sync_info(f);
+        print_time_parameters(f);
     }
 }
 
@@ -144,6 +132,7 @@ void print_common_settings(const reprompib_common_options_t* opts, const print_s
     int my_rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
 
+    gather_time_parameters();
     print_benchmark_common_settings_to_file(stdout, opts, print_sync_info, dict);
     if (my_rank == OUTPUT_ROOT_PROC) {
         if (opts->output_file != NULL) {
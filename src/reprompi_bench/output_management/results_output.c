@@ -49,7 +49,9 @@ static const output_msize_t OUTPUT_MSIZE_TYPE = OUTPUT_MSIZE_BYTES;
 static const output_msize_t OUTPUT_MSIZE_TYPE = OUTPUT_COUNT;
 #endif
 
-void print_results_header(const reprompib_options_t* opts, const char* output_file_path, int verbose) {
+void print_results_header(const reprompib_options_t* opts, const char* output_file_path, int verbose,
+        sync_errorcodes_t get_errorcodes, sync_start_errors_t get_start_errors,
+        sync_window_slack_t get_window_slack, const int print_n_inner) {
     int my_rank;
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
@@ -68,7 +70,11 @@ void print_results_header(const reprompib_options_t* opts, const char* output_fi
         // print summary to stdout
         if (opts->print_summary_methods >0) {
           int i;
-          fprintf(f, "%50s %12s %10s %10s ", "test", msize_str, "total_nrep", "valid_nrep");
+          fprintf(f, "%50s %12s ", "test", msize_str);
+          if (print_n_inner) {
+            fprintf(f, "%10s ", "n_inner");
+          }
+          fprintf(f, "%10s %10s ", "total_nrep", "valid_nrep");
 
           for (i=0; i<reprompib_get_number_summary_methods(); i++) {
             summary_method_info_t* s = reprompib_get_summary_method(i);
@@ -90,21 +96,31 @@ void print_results_header(const reprompib_options_t* opts, const char* output_fi
                 fprintf(f, "process ");
             }
 
-#ifdef ENABLE_WINDOWSYNC
-            fprintf(f, "%50s %10s %12s %10s ", "test", "nrep", msize_str, "errorcode");
-#else
             fprintf(f, "%50s %10s %12s ", "test", "nrep", msize_str);
-#endif
+            if (print_n_inner) {
+                fprintf(f, "%10s ", "n_inner");
+            }
+            if (get_errorcodes != NULL) {  // window-based synchronization or global times
+                fprintf(f, "%10s ", "errorcode");
+            }
 
             if (verbose == 1) {
-#ifdef ENABLE_WINDOWSYNC
-                fprintf(f, "%14s %14s %14s %14s \n", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
-#else
-                fprintf(f,  "%14s %14s \n", "loc_tstart_sec", "loc_tend_sec");
-#endif
+                if (get_errorcodes != NULL) {
+                    fprintf(f, "%14s %14s %14s %14s ", "loc_tstart_sec", "loc_tend_sec", "gl_tstart_sec", "gl_tend_sec");
+                } else {
+                    fprintf(f,  "%14s %14s ", "loc_tstart_sec", "loc_tend_sec");
+                }
             } else {
-                fprintf(f,  "%14s \n", "runtime_sec");
+                fprintf(f,  "%14s ", "runtime_sec");
+            }
+
+            if (get_start_errors != NULL) {   // window-based synchronization
+                fprintf(f, "%14s ", "start_err_sec");
             }
+            if (get_window_slack != NULL) {
+                fprintf(f, "%14s ", "win_slack_sec");
+            }
+            fprintf(f, "\n");
         }
 
         if (output_file_path != NULL) {
@@ -121,17 +137,33 @@ void print_results_header(const reprompib_options_t* opts, const char* output_fi
 
 
 
+/* a repetition measures job.n_inner calls, the mean runtime per call is reported */
+static void compute_runtimes_per_call(const job_t* job, double* maxRuntimes_sec) {
+    long i;
+
+    if (job->n_inner > 1) {
+        for (i = 0; i < job->n_rep; i++) {
+            maxRuntimes_sec[i] /= job->n_inner;
+        }
+    }
+}
+
+
 void print_runtimes(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time) {
+        const reprompi_raw_ticks_t* raw_ticks,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        sync_start_errors_t get_start_errors, sync_window_slack_t get_window_slack,
+        const int print_n_inner) {
 
     double* maxRuntimes_sec;
+    double* maxStartErrors_sec = NULL;
+    double* minWindowSlack_sec = NULL;
     int i;
     int my_rank;
     long current_start_index;
     size_t msize_value;
-#ifdef ENABLE_WINDOWSYNC
     int* sync_errorcodes = NULL;
-#endif
+
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
 
     if (OUTPUT_MSIZE_TYPE == OUTPUT_MSIZE_BYTES) {
@@ -146,42 +178,71 @@ void print_runtimes(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
     if (my_rank == OUTPUT_ROOT_PROC) {
         maxRuntimes_sec = (double*) malloc(job.n_rep * sizeof(double));
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job.n_rep * sizeof(int));
-        for (i = 0; i < job.n_rep; i++) {
-            sync_errorcodes[i] = 0;
+        if (get_errorcodes != NULL) {
+            sync_errorcodes = (int*) malloc(job.n_rep * sizeof(int));
+            for (i = 0; i < job.n_rep; i++) {
+                sync_errorcodes[i] = 0;
+            }
+        }
+        if (get_start_errors != NULL) {
+            maxStartErrors_sec = (double*) malloc(job.n_rep * sizeof(double));
+        }
+        if (get_window_slack != NULL) {
+            minWindowSlack_sec = (double*) malloc(job.n_rep * sizeof(double));
         }
-#endif
     }
 
     current_start_index = 0;
 
-#ifdef ENABLE_WINDOWSYNC
-    compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            get_errorcodes, get_global_time,
-            maxRuntimes_sec, sync_errorcodes);
-#else
-    compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            maxRuntimes_sec);
-#endif
+    if (raw_ticks != NULL) {
+        compute_runtimes_by_sync_method_ticks(raw_ticks, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    } else {
+        compute_runtimes_by_sync_method(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    }
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        compute_runtimes_per_call(&job, maxRuntimes_sec);
+    }
+
+    if (get_start_errors != NULL) {
+        // report the process that started a repetition the latest
+        MPI_Reduce(get_start_errors(), maxStartErrors_sec, job.n_rep, MPI_DOUBLE, MPI_MAX,
+                OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+    }
+    if (get_window_slack != NULL) {
+        // report the process that finished a repetition the latest
+        MPI_Reduce(get_window_slack(), minWindowSlack_sec, job.n_rep, MPI_DOUBLE, MPI_MIN,
+                OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+    }
 
     if (my_rank == OUTPUT_ROOT_PROC) {
 
         for (i = 0; i < job.n_rep; i++) {
 
-#if defined(ENABLE_WINDOWSYNC) && !defined(ENABLE_BARRIERSYNC)    // measurements with window-based synchronization
-            fprintf(f, "%50s %10d %12ld %10d %14.10f\n", get_call_from_index(job.call_index), i,
-                    msize_value, sync_errorcodes[i],
-                    maxRuntimes_sec[i]);
-#else   // measurements with Barrier-based synchronization
-            fprintf(f, "%50s %10d %12ld %14.10f\n", get_call_from_index(job.call_index), i,
-                    msize_value, maxRuntimes_sec[i]);
-#endif
+            fprintf(f, "%50s %10d %12ld", get_call_from_index(job.call_index), i, msize_value);
+            if (print_n_inner) {
+                fprintf(f, " %10ld", job.n_inner);
+            }
+            if (get_errorcodes != NULL) {   // measurements with window-based synchronization
+                fprintf(f, " %10d", sync_errorcodes[i]);
+            }
+            fprintf(f, " %14.10f", maxRuntimes_sec[i]);
+
+            if (get_start_errors != NULL) {
+                fprintf(f, " %14.10f", maxStartErrors_sec[i]);
+            }
+            if (get_window_slack != NULL) {
+                fprintf(f, " %14.10f", minWindowSlack_sec[i]);
+            }
+            fprintf(f, "\n");
         }
 
-#ifdef ENABLE_WINDOWSYNC
         free(sync_errorcodes);
-#endif
+        free(maxStartErrors_sec);
+        free(minWindowSlack_sec);
 
         free(maxRuntimes_sec);
     }
@@ -190,21 +251,26 @@ void print_runtimes(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
 
 
 void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompi_raw_ticks_t* raw_ticks,
         sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
-        int verbose) {
+        sync_start_errors_t get_start_errors, sync_window_slack_t get_window_slack, int verbose,
+        const int print_n_inner) {
 
     int i, proc_id;
     double* local_start_sec = NULL;
     double* local_end_sec = NULL;
+    double* chunk_tstart_sec;
+    double* chunk_tend_sec;
     double* global_start_sec = NULL;
     double* global_end_sec = NULL;
     int my_rank, np;
     int chunk_id, nchunks;
     int current_rep_id, chunk_nrep = 0;
     size_t msize_value;
-#ifdef ENABLE_WINDOWSYNC
     int* errorcodes = NULL;
-#endif
+    double* start_errors = NULL;
+    double* window_slack = NULL;
+    long chunk_offset;
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &np);
@@ -217,8 +283,8 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
     }
 
     if (verbose == 0) {
-        print_runtimes(f, job, tstart_sec, tend_sec, get_errorcodes,
-                get_global_time);
+        print_runtimes(f, job, tstart_sec, tend_sec, raw_ticks, get_errorcodes,
+                get_global_time, get_start_errors, get_window_slack, print_n_inner);
     } else {
 
         // we gather data from processes in chunks of OUTPUT_NITERATIONS_CHUNK elements
@@ -234,25 +300,38 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
             else {
                 chunk_nrep = OUTPUT_NITERATIONS_CHUNK;
             }
+            chunk_offset = (long)chunk_id * OUTPUT_NITERATIONS_CHUNK;
 
-#ifdef ENABLE_WINDOWSYNC
-            if (my_rank == OUTPUT_ROOT_PROC)
-            {
-              errorcodes = (int*)malloc(chunk_nrep * np * sizeof(int));
-              for (i = 0; i < chunk_nrep * np; i++) {
-                errorcodes[i] = 0;
-              }
-            }
-#ifndef ENABLE_BARRIERSYNC	// gather measurement results
-            {
+            if (get_errorcodes != NULL) {
                 int* local_errorcodes = get_errorcodes();
 
-                MPI_Gather(local_errorcodes, chunk_nrep, MPI_INT,
+                if (my_rank == OUTPUT_ROOT_PROC)
+                {
+                  errorcodes = (int*)malloc(chunk_nrep * np * sizeof(int));
+                  for (i = 0; i < chunk_nrep * np; i++) {
+                    errorcodes[i] = 0;
+                  }
+                }
+
+                // gather measurement results
+                MPI_Gather(local_errorcodes + chunk_offset, chunk_nrep, MPI_INT,
                         errorcodes, chunk_nrep, MPI_INT, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
             }
-#endif
 
-#endif
+            if (get_start_errors != NULL) {
+                if (my_rank == OUTPUT_ROOT_PROC) {
+                    start_errors = (double*) malloc(chunk_nrep * np * sizeof(double));
+                }
+                MPI_Gather(get_start_errors() + chunk_offset, chunk_nrep, MPI_DOUBLE,
+                        start_errors, chunk_nrep, MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+            }
+            if (get_window_slack != NULL) {
+                if (my_rank == OUTPUT_ROOT_PROC) {
+                    window_slack = (double*) malloc(chunk_nrep * np * sizeof(double));
+                }
+                MPI_Gather(get_window_slack() + chunk_offset, chunk_nrep, MPI_DOUBLE,
+                        window_slack, chunk_nrep, MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
+            }
 
             if (my_rank == OUTPUT_ROOT_PROC) {
                 local_start_sec = (double*) malloc(
@@ -265,43 +344,71 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
                         chunk_nrep * np * sizeof(double));
             }
 
+            if (raw_ticks != NULL) {
+                // raw ticks are converted one chunk at a time
+                chunk_tstart_sec = (double*) malloc(chunk_nrep * sizeof(double));
+                chunk_tend_sec = (double*) malloc(chunk_nrep * sizeof(double));
+                for (i = 0; i < chunk_nrep; i++) {
+                    chunk_tstart_sec[i] = raw_ticks->ticks_to_time(raw_ticks->tstart[chunk_offset + i]);
+                    chunk_tend_sec[i] = raw_ticks->ticks_to_time(raw_ticks->tend[chunk_offset + i]);
+                }
+            } else {
+                chunk_tstart_sec = tstart_sec + chunk_offset;
+                chunk_tend_sec = tend_sec + chunk_offset;
+            }
+
             // gather measurement results
-            MPI_Gather(tstart_sec, chunk_nrep, MPI_DOUBLE, local_start_sec,
+            MPI_Gather(chunk_tstart_sec, chunk_nrep, MPI_DOUBLE, local_start_sec,
                     chunk_nrep, MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
 
-            MPI_Gather(tend_sec, chunk_nrep, MPI_DOUBLE, local_end_sec, chunk_nrep,
+            MPI_Gather(chunk_tend_sec, chunk_nrep, MPI_DOUBLE, local_end_sec, chunk_nrep,
                     MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
 
             for (i = 0; i < chunk_nrep; i++) {
-                tstart_sec[i] = get_global_time(tstart_sec[i]);
-                tend_sec[i] = get_global_time(tend_sec[i]);
+                chunk_tstart_sec[i] = get_global_time(chunk_tstart_sec[i]);
+                chunk_tend_sec[i] = get_global_time(chunk_tend_sec[i]);
             }
-            MPI_Gather(tstart_sec, chunk_nrep, MPI_DOUBLE, global_start_sec,
+            MPI_Gather(chunk_tstart_sec, chunk_nrep, MPI_DOUBLE, global_start_sec,
                     chunk_nrep, MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
 
-            MPI_Gather(tend_sec, chunk_nrep, MPI_DOUBLE, global_end_sec, chunk_nrep,
+            MPI_Gather(chunk_tend_sec, chunk_nrep, MPI_DOUBLE, global_end_sec, chunk_nrep,
                     MPI_DOUBLE, OUTPUT_ROOT_PROC, MPI_COMM_WORLD);
 
+            if (raw_ticks != NULL) {
+                free(chunk_tstart_sec);
+                free(chunk_tend_sec);
+            }
+
             if (my_rank == OUTPUT_ROOT_PROC) {
 
                 for (proc_id = 0; proc_id < np; proc_id++) {
                     for (i = 0; i < chunk_nrep; i++) {
                         current_rep_id = chunk_id * OUTPUT_NITERATIONS_CHUNK + i;
-#ifdef ENABLE_WINDOWSYNC
-                        fprintf(f, "%7d %50s %10d %12ld %10d %14.10f %14.10f %14.10f %14.10f\n", proc_id,
-                                get_call_from_index(job.call_index), current_rep_id, msize_value,
-                                errorcodes[proc_id * chunk_nrep + i],
-                                local_start_sec[proc_id * chunk_nrep + i],
-                                local_end_sec[proc_id * chunk_nrep + i],
-                                global_start_sec[proc_id * chunk_nrep + i],
-                                global_end_sec[proc_id * chunk_nrep + i]);
-
-#else
-                        fprintf(f, "%7d %50s %10d %12ld %14.10f %14.10f\n", proc_id,
-                                get_call_from_index(job.call_index), current_rep_id, msize_value,
-                                local_start_sec[proc_id * chunk_nrep + i],
-                                local_end_sec[proc_id * chunk_nrep + i]);
-#endif
+                        fprintf(f, "%7d %50s %10d %12ld", proc_id,
+                                get_call_from_index(job.call_index), current_rep_id, msize_value);
+                        if (print_n_inner) {
+                            fprintf(f, " %10ld", job.n_inner);
+                        }
+                        if (get_errorcodes != NULL) {
+                            fprintf(f, " %10d %14.10f %14.10f %14.10f %14.10f",
+                                    errorcodes[proc_id * chunk_nrep + i],
+                                    local_start_sec[proc_id * chunk_nrep + i],
+                                    local_end_sec[proc_id * chunk_nrep + i],
+                                    global_start_sec[proc_id * chunk_nrep + i],
+                                    global_end_sec[proc_id * chunk_nrep + i]);
+                        } else {
+                            fprintf(f, " %14.10f %14.10f",
+                                    local_start_sec[proc_id * chunk_nrep + i],
+                                    local_end_sec[proc_id * chunk_nrep + i]);
+                        }
+
+                        if (get_start_errors != NULL) {
+                            fprintf(f, " %14.10f", start_errors[proc_id * chunk_nrep + i]);
+                        }
+                        if (get_window_slack != NULL) {
+                            fprintf(f, " %14.10f", window_slack[proc_id * chunk_nrep + i]);
+                        }
+                        fprintf(f, "\n");
                     }
                 }
 
@@ -309,9 +416,12 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
                 free(local_end_sec);
                 free(global_start_sec);
                 free(global_end_sec);
-#ifdef ENABLE_WINDOWSYNC
                 free(errorcodes);
-#endif
+                errorcodes = NULL;
+                free(start_errors);
+                start_errors = NULL;
+                free(window_slack);
+                window_slack = NULL;
             }
 
         }
@@ -322,17 +432,16 @@ void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* t
 
 
 void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompi_raw_ticks_t* raw_ticks,
         sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
-        const int print_summary_methods) {
+        const int print_summary_methods, const int print_n_inner) {
 
     double* maxRuntimes_sec;
     int my_rank;
     long current_start_index;
     size_t msize_value;
-#ifdef ENABLE_WINDOWSYNC
     int i;
     int* sync_errorcodes = NULL;
-#endif
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
 
@@ -348,45 +457,53 @@ void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
     if (my_rank == OUTPUT_ROOT_PROC) {
         maxRuntimes_sec = (double*) malloc(job.n_rep * sizeof(double));
 
-#ifdef ENABLE_WINDOWSYNC
-        sync_errorcodes = (int*) malloc(job.n_rep * sizeof(int));
-        for (i = 0; i < job.n_rep; i++) {
-            sync_errorcodes[i] = 0;
+        if (get_errorcodes != NULL) {
+            sync_errorcodes = (int*) malloc(job.n_rep * sizeof(int));
+            for (i = 0; i < job.n_rep; i++) {
+                sync_errorcodes[i] = 0;
+            }
         }
-#endif
     }
 
     current_start_index = 0;
 
-#ifdef ENABLE_WINDOWSYNC
-    compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            get_errorcodes, get_global_time,
-            maxRuntimes_sec, sync_errorcodes);
-#else
-    compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
-            maxRuntimes_sec);
-#endif
+    if (raw_ticks != NULL) {
+        compute_runtimes_by_sync_method_ticks(raw_ticks, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    } else {
+        compute_runtimes_by_sync_method(tstart_sec, tend_sec, current_start_index, job.n_rep, OUTPUT_ROOT_PROC,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    }
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        compute_runtimes_per_call(&job, maxRuntimes_sec);
+    }
 
 
     if (my_rank == OUTPUT_ROOT_PROC) {
         long nreps = 0;
 
         // remove measurements with out-of-window errors
-#ifdef ENABLE_WINDOWSYNC
-        for (i = 0; i < job.n_rep; i++) {
-            if (sync_errorcodes[i] == 0) {
-                if (nreps < i) {
-                    maxRuntimes_sec[nreps] = maxRuntimes_sec[i];
+        if (get_errorcodes != NULL) {
+            for (i = 0; i < job.n_rep; i++) {
+                if (sync_errorcodes[i] == 0) {
+                    if (nreps < i) {
+                        maxRuntimes_sec[nreps] = maxRuntimes_sec[i];
+                    }
+                    nreps++;
                 }
-                nreps++;
             }
+        } else {
+            nreps = job.n_rep;
         }
-#else
-        nreps = job.n_rep;
-#endif
 
         gsl_sort(maxRuntimes_sec, 1, nreps);
-        fprintf(f, "%50s %12ld %10ld %10ld ", get_call_from_index(job.call_index), msize_value, job.n_rep, nreps);
+        fprintf(f, "%50s %12ld ", get_call_from_index(job.call_index), msize_value);
+        if (print_n_inner) {
+            fprintf(f, "%10ld ", job.n_inner);
+        }
+        fprintf(f, "%10ld %10ld ", job.n_rep, nreps);
 
         if (print_summary_methods > 0) {
           int i;
@@ -418,9 +535,7 @@ void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
         }
         fprintf(f, "\n");
 
-#ifdef ENABLE_WINDOWSYNC
         free(sync_errorcodes);
-#endif
 
         free(maxRuntimes_sec);
     }
@@ -26,16 +26,28 @@
 
 #include "benchmark_job.h"
 #include "reprompi_bench/sync/synchronization.h"
+#include "runtimes_computation.h"
 
-void print_results_header(const reprompib_options_t* opts, const char* output_file_path, int verbose);
+void print_results_header(const reprompib_options_t* opts, const char* output_file_path, int verbose,
+        sync_errorcodes_t get_errorcodes, sync_start_errors_t get_start_errors,
+        sync_window_slack_t get_window_slack, const int print_n_inner);
 
+/* with raw_ticks != NULL (--raw-ticks), the timestamps are read from raw_ticks
+ * and tstart_sec/tend_sec are not used;
+ * with get_window_slack != NULL (--sync-diagnostics), the slack left in each window is added;
+ * with print_n_inner != 0, the number of calls per repetition of the job is added (the runtimes
+ * are per call, the verbose timestamps delimit all calls of a repetition) */
 void print_measurement_results(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+		const reprompi_raw_ticks_t* raw_ticks,
 		sync_errorcodes_t get_errorcodes,
 		sync_normtime_t get_global_time,
-		int verbose);
+		sync_start_errors_t get_start_errors,
+		sync_window_slack_t get_window_slack,
+		int verbose, const int print_n_inner);
 
 void print_summary(FILE* f, job_t job, double* tstart_sec, double* tend_sec,
+        const reprompi_raw_ticks_t* raw_ticks,
         sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
-        const int print_summary_methods);
+        const int print_summary_methods, const int print_n_inner);
 
 #endif /* RESULTS_OUTPUT_H_ */
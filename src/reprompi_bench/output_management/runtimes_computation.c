@@ -55,16 +55,15 @@ void compute_runtimes_local_clocks(const double* tstart_sec, const double* tend_
 
 
 
-void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend_sec,
+/* reduces the error codes and the normalized start and end times of the current repetitions on the root */
+static void reduce_global_runtimes(const double* norm_tstart_sec, const double* norm_tend_sec,
         long current_start_index, long current_nreps, int root_proc,
-        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        sync_errorcodes_t get_errorcodes,
         double* maxRuntimes_sec, int* sync_errorcodes) {
 
     double* start_sec = NULL;
     double* end_sec = NULL;
-    double* norm_tstart_sec;
-    double* norm_tend_sec;
-    int i, index;
+    int i;
     int my_rank;
     int* local_errorcodes;
 
@@ -82,16 +81,6 @@ void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend
         end_sec = (double*)malloc(current_nreps * sizeof(double));
     }
 
-    norm_tstart_sec = (double*)malloc(current_nreps * sizeof(double));
-    norm_tend_sec = (double*)malloc(current_nreps * sizeof(double));
-
-    // normalize results in the  [current_start_index, current_start_index + current_nreps) interval
-    for (i = 0; i < current_nreps; i++) {
-        index = i + current_start_index;
-        norm_tstart_sec[i] = get_global_time(tstart_sec[index]);
-        norm_tend_sec[i] = get_global_time(tend_sec[index]);
-    }
-
     // gather results at the root process and compute runtimes
     MPI_Reduce(norm_tstart_sec, start_sec, current_nreps, MPI_DOUBLE, MPI_MIN, root_proc, MPI_COMM_WORLD);
     MPI_Reduce(norm_tend_sec, end_sec, current_nreps, MPI_DOUBLE, MPI_MAX, root_proc, MPI_COMM_WORLD);
@@ -105,9 +94,112 @@ void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend
         free(start_sec);
         free(end_sec);
     }
+}
+
+
+void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend_sec,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes) {
+
+    double* norm_tstart_sec;
+    double* norm_tend_sec;
+    int i, index;
+
+    norm_tstart_sec = (double*)malloc(current_nreps * sizeof(double));
+    norm_tend_sec = (double*)malloc(current_nreps * sizeof(double));
+
+    // normalize results in the  [current_start_index, current_start_index + current_nreps) interval
+    for (i = 0; i < current_nreps; i++) {
+        index = i + current_start_index;
+        norm_tstart_sec[i] = get_global_time(tstart_sec[index]);
+        norm_tend_sec[i] = get_global_time(tend_sec[index]);
+    }
+
+    reduce_global_runtimes(norm_tstart_sec, norm_tend_sec, current_start_index, current_nreps, root_proc,
+            get_errorcodes, maxRuntimes_sec, sync_errorcodes);
 
     free(norm_tstart_sec);
     free(norm_tend_sec);
 
 }
 
+
+
+void compute_runtimes_by_sync_method(const double* tstart_sec, const double* tend_sec,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes) {
+
+    if (get_errorcodes != NULL) {   // window-based synchronization or barriers with global times
+        compute_runtimes_global_clocks(tstart_sec, tend_sec, current_start_index, current_nreps, root_proc,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    } else {
+        compute_runtimes_local_clocks(tstart_sec, tend_sec, current_start_index, current_nreps, root_proc,
+                maxRuntimes_sec);
+    }
+}
+
+
+/* the local runtimes are computed from the tick differences, so that they keep the full timer resolution */
+void compute_runtimes_local_ticks(const reprompi_raw_ticks_t* raw_ticks,
+        long current_start_index, long current_nreps, int root_proc,
+        double* maxRuntimes_sec) {
+
+    double* local_runtimes = NULL;
+    int i, index;
+
+    local_runtimes = (double*) malloc(current_nreps * sizeof(double));
+    for (i = 0; i < current_nreps; i++) {
+        index = i + current_start_index;
+        local_runtimes[i] = ticks_to_sec(raw_ticks->tend[index] - raw_ticks->tstart[index]);
+    }
+
+    MPI_Reduce(local_runtimes, maxRuntimes_sec, current_nreps,
+            MPI_DOUBLE, MPI_MAX, root_proc, MPI_COMM_WORLD);
+
+    free(local_runtimes);
+}
+
+
+void compute_runtimes_global_ticks(const reprompi_raw_ticks_t* raw_ticks,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes) {
+
+    double* norm_tstart_sec;
+    double* norm_tend_sec;
+    int i, index;
+
+    norm_tstart_sec = (double*)malloc(current_nreps * sizeof(double));
+    norm_tend_sec = (double*)malloc(current_nreps * sizeof(double));
+
+    for (i = 0; i < current_nreps; i++) {
+        index = i + current_start_index;
+        norm_tstart_sec[i] = get_global_time(raw_ticks->ticks_to_time(raw_ticks->tstart[index]));
+        norm_tend_sec[i] = get_global_time(raw_ticks->ticks_to_time(raw_ticks->tend[index]));
+    }
+
+    reduce_global_runtimes(norm_tstart_sec, norm_tend_sec, current_start_index, current_nreps, root_proc,
+            get_errorcodes, maxRuntimes_sec, sync_errorcodes);
+
+    free(norm_tstart_sec);
+    free(norm_tend_sec);
+}
+
+
+void compute_runtimes_by_sync_method_ticks(const reprompi_raw_ticks_t* raw_ticks,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes) {
+
+    if (get_errorcodes != NULL) {
+        compute_runtimes_global_ticks(raw_ticks, current_start_index, current_nreps, root_proc,
+                get_errorcodes, get_global_time,
+                maxRuntimes_sec, sync_errorcodes);
+    } else {
+        compute_runtimes_local_ticks(raw_ticks, current_start_index, current_nreps, root_proc,
+                maxRuntimes_sec);
+    }
+}
@@ -26,6 +26,14 @@
 
 #include "reprompi_bench/sync/synchronization.h"
 
+/* timestamps stored as raw timer ticks (--raw-ticks); they are only converted
+ * to seconds when the runtimes are computed */
+typedef struct {
+    const reprompi_ticks_t* tstart;
+    const reprompi_ticks_t* tend;
+    sync_ticks_to_time_t ticks_to_time;
+} reprompi_raw_ticks_t;
+
 void compute_runtimes_local_clocks(const double* tstart_sec, const double* tend_sec,
         long current_start_index, long current_nreps, int root_proc,
         double* maxRuntimes_sec);
@@ -34,6 +42,23 @@ void compute_runtimes_global_clocks(const double* tstart_sec, const double* tend
         sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
         double* maxRuntimes_sec, int* sync_errorcodes);
 
+// global clocks for methods that provide error codes, local clocks otherwise
+void compute_runtimes_by_sync_method(const double* tstart_sec, const double* tend_sec,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes);
+
+void compute_runtimes_local_ticks(const reprompi_raw_ticks_t* raw_ticks,
+        long current_start_index, long current_nreps, int root_proc,
+        double* maxRuntimes_sec);
+void compute_runtimes_global_ticks(const reprompi_raw_ticks_t* raw_ticks,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes);
+void compute_runtimes_by_sync_method_ticks(const reprompi_raw_ticks_t* raw_ticks,
+        long current_start_index, long current_nreps, int root_proc,
+        sync_errorcodes_t get_errorcodes, sync_normtime_t get_global_time,
+        double* maxRuntimes_sec, int* sync_errorcodes);
 
 
 #endif /* RUNTIMES_COMPUTATION_H_ */
@@ -0,0 +1,148 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mpi.h"
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+#include "adaptive_window.h"
+
+// the window is sized as the PILOT_QUANTILE of the pilot window usage (maximum over all processes) plus a margin
+static const double PILOT_QUANTILE = 0.95;
+static const double WINDOW_MARGIN = 0.5;
+
+// window size changes between batches depending on the fraction of windows with error codes
+static const double MAX_ERROR_RATE = 0.05;
+static const double WINDOW_GROW_FACTOR = 1.5;
+static const double WINDOW_SHRINK_FACTOR = 0.9;
+
+
+void reprompi_adaptive_window_init(reprompi_adaptive_window_t* aw, const reprompib_sync_options_t* opts) {
+    aw->enabled = opts->adaptive_window;
+    aw->n_pilot = opts->adaptive_window_pilot;
+    aw->batch_size = opts->adaptive_window_batch;
+    aw->n_windows = 0;
+    aw->n_batch_errors = 0;
+    aw->pilot_durations = NULL;
+    aw->pilot_window_size_sec = -1;
+    aw->window_size_sec = opts->window_size_sec;
+
+    if (aw->enabled) {
+        aw->pilot_durations = (double*) calloc(aw->n_pilot, sizeof(double));
+    }
+}
+
+
+void reprompi_adaptive_window_cleanup(reprompi_adaptive_window_t* aw) {
+    free(aw->pilot_durations);
+    aw->pilot_durations = NULL;
+}
+
+
+int reprompi_adaptive_window_update(reprompi_adaptive_window_t* aw, const double window_usage,
+        const int errorcode, double* window_size_sec) {
+    double local_quantile, max_quantile;
+    long n_errors;
+    int np;
+    double error_rate;
+
+    if (!aw->enabled) {
+        return 0;
+    }
+
+    if (aw->n_windows < aw->n_pilot) {
+        aw->pilot_durations[aw->n_windows] = window_usage;
+    } else if (errorcode != 0) {
+        aw->n_batch_errors++;
+    }
+    aw->n_windows++;
+
+    if (aw->n_windows == aw->n_pilot) {
+        gsl_sort(aw->pilot_durations, 1, aw->n_pilot);
+        local_quantile = gsl_stats_quantile_from_sorted_data(aw->pilot_durations, 1, aw->n_pilot, PILOT_QUANTILE);
+        MPI_Allreduce(&local_quantile, &max_quantile, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        *window_size_sec = max_quantile * (1.0 + WINDOW_MARGIN);
+        aw->pilot_window_size_sec = *window_size_sec;
+        aw->window_size_sec = *window_size_sec;
+        return 1;
+    }
+
+    if (aw->n_windows > aw->n_pilot && (aw->n_windows - aw->n_pilot) % aw->batch_size == 0) {
+        MPI_Comm_size(MPI_COMM_WORLD, &np);
+        MPI_Allreduce(&aw->n_batch_errors, &n_errors, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+        aw->n_batch_errors = 0;
+
+        error_rate = (double)n_errors / (double)(aw->batch_size * np);
+        if (error_rate > MAX_ERROR_RATE) {
+            *window_size_sec *= WINDOW_GROW_FACTOR;
+        } else if (n_errors == 0) {
+            *window_size_sec *= WINDOW_SHRINK_FACTOR;
+        }
+        aw->window_size_sec = *window_size_sec;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+void reprompi_print_adaptive_window_info(FILE* f, const reprompi_adaptive_window_t* aw) {
+    if (aw->enabled) {
+        fprintf(f, "#@adaptive_window=1\n");
+        fprintf(f, "#@adaptive_window_pilot=%ld\n", aw->n_pilot);
+        fprintf(f, "#@adaptive_window_batch=%ld\n", aw->batch_size);
+    }
+}
+
+
+static void print_window_sizes(FILE* f, const reprompi_adaptive_window_t* aw) {
+    if (aw->pilot_window_size_sec >= 0) {
+        fprintf(f, "#@adaptive_window_pilot_s=%.10f\n", aw->pilot_window_size_sec);
+    }
+    fprintf(f, "#@adaptive_window_final_s=%.10f\n", aw->window_size_sec);
+}
+
+
+void reprompi_print_adaptive_window_sizes(const reprompi_adaptive_window_t* aw, const char* output_file) {
+    int my_rank;
+    FILE* f;
+
+    if (!aw->enabled) {
+        return;
+    }
+
+    // all processes agree on the window size, so the root reports it
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == 0) {
+        print_window_sizes(stdout, aw);
+        if (output_file != NULL) {
+            f = fopen(output_file, "a");
+            print_window_sizes(f, aw);
+            fflush(f);
+            fclose(f);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_ADAPTIVE_WINDOW_H_
+#define REPROMPI_ADAPTIVE_WINDOW_H_
+
+#include <stdio.h>
+#include "sync_info.h"
+
+typedef struct {
+    int enabled;            /* --adaptive-window */
+    long n_pilot;           /* --adaptive-window-pilot */
+    long batch_size;        /* --adaptive-window-batch */
+
+    double* pilot_durations;    /* window usage measured in the pilot windows */
+    long n_windows;             /* number of windows observed in the current job */
+    long n_batch_errors;        /* windows with error codes in the current batch */
+    double pilot_window_size_sec;   /* window size chosen after the pilot windows (-1: pilot not finished) */
+    double window_size_sec;         /* window size currently used */
+} reprompi_adaptive_window_t;
+
+void reprompi_adaptive_window_init(reprompi_adaptive_window_t* aw, const reprompib_sync_options_t* opts);
+void reprompi_adaptive_window_cleanup(reprompi_adaptive_window_t* aw);
+
+/*
+ * Record the time used by the last window (from the window start to the end
+ * of the measurement) and its error code. After the pilot windows and at the
+ * end of each batch, all processes agree on a new window size.
+ * Returns 1 if the processes communicated to agree on a window size (which
+ * takes time), in which case the caller has to restart its windows.
+ * All processes return the same value.
+ */
+int reprompi_adaptive_window_update(reprompi_adaptive_window_t* aw, const double window_usage,
+        const int errorcode, double* window_size_sec);
+
+void reprompi_print_adaptive_window_info(FILE* f, const reprompi_adaptive_window_t* aw);
+
+/*
+ * Print the window size chosen after the pilot windows and the one used at
+ * the end of the current job (on the root, to stdout and to output_file if
+ * not NULL). The job has to be finished before the module is cleaned up.
+ */
+void reprompi_print_adaptive_window_sizes(const reprompi_adaptive_window_t* aw, const char* output_file);
+
+#endif /* REPROMPI_ADAPTIVE_WINDOW_H_ */
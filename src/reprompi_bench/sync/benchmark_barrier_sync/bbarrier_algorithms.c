@@ -0,0 +1,273 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include "mpi.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "reprompi_bench/sync/node_sync.h"
+#include "bbarrier_algorithms.h"
+
+static const int BBARRIER_DISSEMINATION_TAG = 0;
+static const int BBARRIER_TOURNAMENT_TAG = 51;
+static const int BBARRIER_BUTTERFLY_TAG = 52;
+
+static const char* const bbarrier_names[] = {
+        [BBARRIER_DISSEMINATION] = "dissemination",
+        [BBARRIER_TOURNAMENT] = "tournament",
+        [BBARRIER_BUTTERFLY] = "butterfly",
+        [BBARRIER_HIERARCHICAL] = "hierarchical"
+};
+
+static reprompi_bbarrier_type_t bbarrier_type = BBARRIER_DISSEMINATION;
+
+/* state of the hierarchical barrier, created on its first use */
+typedef struct {
+    int initialized;
+    MPI_Comm node_comm;
+    MPI_Comm leaders_comm;
+    MPI_Win win;
+    int* flags;     /* flags[0]: release episode, flags[i]: arrival episode of node rank i */
+    int node_rank;
+    int node_size;
+    int episode;
+} hierarchical_barrier_t;
+
+static hierarchical_barrier_t hier = { 0 };
+
+
+const char* reprompi_get_bbarrier_name(reprompi_bbarrier_type_t type) {
+  if (type < 0 || type >= REPROMPI_N_BBARRIER_TYPES) {
+    return "unknown";
+  }
+  return bbarrier_names[type];
+}
+
+
+/* returns 0 on success and 1 if the name does not match any barrier */
+int reprompi_parse_bbarrier_type(const char* name, reprompi_bbarrier_type_t* type) {
+  int i;
+
+  if (name == NULL) {
+    return 1;
+  }
+  for (i = 0; i < REPROMPI_N_BBARRIER_TYPES; i++) {
+    if (strcmp(name, bbarrier_names[i]) == 0) {
+      *type = (reprompi_bbarrier_type_t)i;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+
+void reprompi_bbarrier_set_type(reprompi_bbarrier_type_t type) {
+    bbarrier_type = type;
+}
+
+reprompi_bbarrier_type_t reprompi_bbarrier_get_type(void) {
+    return bbarrier_type;
+}
+
+
+static void dissemination_barrier_on_comm(MPI_Comm comm) {
+    int my_rank, np, send_rank, recv_rank;
+    int i, nrounds;
+    MPI_Status status;
+    int send_value = 1;
+    int recv_value = 1;
+
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
+
+    nrounds = ceil(log2((double) np));
+
+    for (i = 0; i < nrounds; i++) {
+        send_rank = (my_rank + (1<<i)) % np;
+        recv_rank = (my_rank - (1 << i) + np) % np;
+
+        //printf("[%d] Sending from %d to %d; receive from %d\n", i, my_rank, send_rank, recv_rank);
+        MPI_Sendrecv(&send_value, 1, MPI_INT, send_rank, BBARRIER_DISSEMINATION_TAG,
+                &recv_value, 1, MPI_INT, recv_rank, BBARRIER_DISSEMINATION_TAG,
+                comm, &status);
+    }
+}
+
+
+void dissemination_barrier(void) {
+    dissemination_barrier_on_comm(MPI_COMM_WORLD);
+}
+
+
+static void tournament_barrier(void) {
+    int my_rank, np, mask;
+    int token = 1;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    // arrival: in round k, the process with bit k set loses against the one without it
+    for (mask = 1; mask < np; mask <<= 1) {
+        if (my_rank & mask) {
+            MPI_Send(&token, 1, MPI_INT, my_rank - mask, BBARRIER_TOURNAMENT_TAG, MPI_COMM_WORLD);
+            break;
+        }
+        if (my_rank + mask < np) {
+            MPI_Recv(&token, 1, MPI_INT, my_rank + mask, BBARRIER_TOURNAMENT_TAG, MPI_COMM_WORLD,
+                    MPI_STATUS_IGNORE);
+        }
+    }
+
+    // wake-up: wait for the winner of my last match, then release the processes I have beaten
+    if (my_rank != 0) {
+        MPI_Recv(&token, 1, MPI_INT, my_rank - mask, BBARRIER_TOURNAMENT_TAG, MPI_COMM_WORLD,
+                MPI_STATUS_IGNORE);
+    }
+    for (mask >>= 1; mask > 0; mask >>= 1) {
+        if (my_rank + mask < np) {
+            MPI_Send(&token, 1, MPI_INT, my_rank + mask, BBARRIER_TOURNAMENT_TAG, MPI_COMM_WORLD);
+        }
+    }
+}
+
+
+static void butterfly_barrier(void) {
+    int my_rank, np, mask, p2;
+    int send_value = 1;
+    int recv_value = 1;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    for (p2 = 1; (p2 << 1) <= np; p2 <<= 1);
+
+    // processes beyond the largest power of two are represented by my_rank - p2
+    if (my_rank >= p2) {
+        MPI_Send(&send_value, 1, MPI_INT, my_rank - p2, BBARRIER_BUTTERFLY_TAG, MPI_COMM_WORLD);
+        MPI_Recv(&recv_value, 1, MPI_INT, my_rank - p2, BBARRIER_BUTTERFLY_TAG, MPI_COMM_WORLD,
+                MPI_STATUS_IGNORE);
+        return;
+    }
+    if (my_rank + p2 < np) {
+        MPI_Recv(&recv_value, 1, MPI_INT, my_rank + p2, BBARRIER_BUTTERFLY_TAG, MPI_COMM_WORLD,
+                MPI_STATUS_IGNORE);
+    }
+
+    for (mask = 1; mask < p2; mask <<= 1) {
+        MPI_Sendrecv(&send_value, 1, MPI_INT, my_rank ^ mask, BBARRIER_BUTTERFLY_TAG,
+                &recv_value, 1, MPI_INT, my_rank ^ mask, BBARRIER_BUTTERFLY_TAG,
+                MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+
+    if (my_rank + p2 < np) {
+        MPI_Send(&send_value, 1, MPI_INT, my_rank + p2, BBARRIER_BUTTERFLY_TAG, MPI_COMM_WORLD);
+    }
+}
+
+
+static void hierarchical_barrier_init(void) {
+    MPI_Aint size;
+    int disp_unit;
+    int i;
+
+    reprompi_create_node_comms(&hier.node_comm, &hier.leaders_comm);
+    MPI_Comm_rank(hier.node_comm, &hier.node_rank);
+    MPI_Comm_size(hier.node_comm, &hier.node_size);
+
+    // the flags live in the memory of the node leader
+    size = (hier.node_rank == 0) ? hier.node_size * sizeof(int) : 0;
+    MPI_Win_allocate_shared(size, sizeof(int), MPI_INFO_NULL, hier.node_comm, &hier.flags, &hier.win);
+    MPI_Win_shared_query(hier.win, 0, &size, &disp_unit, &hier.flags);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, hier.win);
+
+    if (hier.node_rank == 0) {
+        for (i = 0; i < hier.node_size; i++) {
+            hier.flags[i] = 0;
+        }
+    }
+    MPI_Win_sync(hier.win);
+    MPI_Barrier(hier.node_comm);
+    MPI_Win_sync(hier.win);
+
+    hier.episode = 0;
+    hier.initialized = 1;
+}
+
+
+static void hierarchical_barrier(void) {
+    int i;
+
+    if (!hier.initialized) {
+        hierarchical_barrier_init();
+    }
+    hier.episode++;
+
+    if (hier.node_rank != 0) {
+        __atomic_store_n(&hier.flags[hier.node_rank], hier.episode, __ATOMIC_RELEASE);
+        while (__atomic_load_n(&hier.flags[0], __ATOMIC_ACQUIRE) != hier.episode);
+    } else {
+        for (i = 1; i < hier.node_size; i++) {
+            while (__atomic_load_n(&hier.flags[i], __ATOMIC_ACQUIRE) != hier.episode);
+        }
+        if (hier.leaders_comm != MPI_COMM_NULL) {
+            dissemination_barrier_on_comm(hier.leaders_comm);
+        }
+        __atomic_store_n(&hier.flags[0], hier.episode, __ATOMIC_RELEASE);
+    }
+}
+
+
+void reprompi_bbarrier_run(reprompi_bbarrier_type_t type) {
+    switch (type) {
+    case BBARRIER_TOURNAMENT:
+        tournament_barrier();
+        break;
+    case BBARRIER_BUTTERFLY:
+        butterfly_barrier();
+        break;
+    case BBARRIER_HIERARCHICAL:
+        hierarchical_barrier();
+        break;
+    case BBARRIER_DISSEMINATION:
+    default:
+        dissemination_barrier();
+        break;
+    }
+}
+
+
+void reprompi_bbarrier(void) {
+    reprompi_bbarrier_run(bbarrier_type);
+}
+
+
+void reprompi_bbarrier_free(void) {
+    if (hier.initialized) {
+        MPI_Win_unlock_all(hier.win);
+        MPI_Win_free(&hier.win);
+        reprompi_free_node_comms(&hier.node_comm, &hier.leaders_comm);
+        hier.initialized = 0;
+    }
+}
@@ -0,0 +1,59 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef BBARRIER_ALGORITHMS_H_
+#define BBARRIER_ALGORITHMS_H_
+
+#include "mpi.h"
+
+/*
+ * Software barriers used by the BBarrier synchronization method and by the
+ * BBarrier call. The variant is selected with --bbarrier (default: dissemination).
+ */
+typedef enum {
+    BBARRIER_DISSEMINATION = 0,     /* ceil(log2(p)) rounds of shifted exchanges */
+    BBARRIER_TOURNAMENT,            /* binomial arrival tree with rank 0 as champion, then wake-up */
+    BBARRIER_BUTTERFLY,             /* pairwise exchanges, extra processes fold into the largest power of two */
+    BBARRIER_HIERARCHICAL           /* shared-memory flags within each node, dissemination across node leaders */
+} reprompi_bbarrier_type_t;
+
+#define REPROMPI_N_BBARRIER_TYPES 4
+
+const char* reprompi_get_bbarrier_name(reprompi_bbarrier_type_t type);
+int reprompi_parse_bbarrier_type(const char* name, reprompi_bbarrier_type_t* type);
+
+void reprompi_bbarrier_set_type(reprompi_bbarrier_type_t type);
+reprompi_bbarrier_type_t reprompi_bbarrier_get_type(void);
+
+/* run the selected barrier on MPI_COMM_WORLD */
+void reprompi_bbarrier(void);
+
+/* run a given barrier on MPI_COMM_WORLD */
+void reprompi_bbarrier_run(reprompi_bbarrier_type_t type);
+
+/* release the node communicators and the shared window of the hierarchical barrier */
+void reprompi_bbarrier_free(void);
+
+void dissemination_barrier(void);
+
+#endif /* BBARRIER_ALGORITHMS_H_ */
@@ -21,58 +21,149 @@
 </license>
 */
 
+// avoid getsubopt bug
+#define _XOPEN_SOURCE 500
+
 #include "mpi.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <getopt.h>
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
 
+#include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/time_measurement.h"
+#include "reprompi_bench/sync/sync_model_cache.h"
+#include "reprompi_bench/sync/sync_pingpong.h"
 #include "bbarrier_sync.h"
 
+static const int BBARRIER_SKEW_PINGPONGS = 20;
+
+/* exit skew (last minus first exit time in the clock of rank 0) of each barrier type */
+typedef struct {
+    double min;
+    double median;
+    double p95;
+    double max;
+} bbarrier_skew_summary_t;
+
+static long skew_nrep = 0;
+static int skew_measured = 0;
+static bbarrier_skew_summary_t skew_summary[REPROMPI_N_BBARRIER_TYPES];
+
+
 inline double bbarrier_get_normalized_time(double local_time) {
     return local_time;
 }
 
+
+static void measure_exit_skew(const long n_barriers) {
+    int my_rank;
+    int type;
+    long i;
+    double offset;
+    double* exit_sec;
+    double* first_exit_sec = NULL;
+    double* last_exit_sec = NULL;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    // exit times are compared in the clock of rank 0
+    offset = reprompi_measure_offset_to_root(get_time, BBARRIER_SKEW_PINGPONGS);
+
+    exit_sec = (double*) malloc(n_barriers * sizeof(double));
+    if (my_rank == 0) {
+        first_exit_sec = (double*) malloc(n_barriers * sizeof(double));
+        last_exit_sec = (double*) malloc(n_barriers * sizeof(double));
+    }
+
+    for (type = 0; type < REPROMPI_N_BBARRIER_TYPES; type++) {
+        reprompi_bbarrier_run(type);    // warm-up
+        for (i = 0; i < n_barriers; i++) {
+            reprompi_bbarrier_run(type);
+            exit_sec[i] = get_time() - offset;
+        }
+
+        MPI_Reduce(exit_sec, first_exit_sec, n_barriers, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+        MPI_Reduce(exit_sec, last_exit_sec, n_barriers, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (my_rank == 0) {
+            for (i = 0; i < n_barriers; i++) {
+                last_exit_sec[i] -= first_exit_sec[i];
+            }
+            gsl_sort(last_exit_sec, 1, n_barriers);
+            skew_summary[type].min = last_exit_sec[0];
+            skew_summary[type].median = gsl_stats_median_from_sorted_data(last_exit_sec, 1, n_barriers);
+            skew_summary[type].p95 = gsl_stats_quantile_from_sorted_data(last_exit_sec, 1, n_barriers, 0.95);
+            skew_summary[type].max = last_exit_sec[n_barriers - 1];
+        }
+    }
+
+    free(exit_sec);
+    free(first_exit_sec);
+    free(last_exit_sec);
+    reprompi_bbarrier_free();
+}
+
+
 void bbarrier_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep) {
+    skew_nrep = parsed_opts.bbarrier_skew_nrep;
+
+    // the skew only depends on the barrier and the machine, measure it once per run
+    if (skew_nrep > 0 && !skew_measured) {
+        measure_exit_skew(skew_nrep);
+        skew_measured = 1;
+    }
 }
 
 void bbarrier_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
-}
+    int c;
 
-void bbarrier_init_synchronization(void) {
-    MPI_Barrier(MPI_COMM_WORLD);
-}
+    reprompi_init_sync_parameters(opts_p);
 
+    optind = 1;
+    optopt = 0;
+    opterr = 0; // ignore invalid options
+    while (1) {
 
-void dissemination_barrier(void) {
-    int my_rank, np, send_rank, recv_rank;
-    int i, nrounds;
-    MPI_Status status;
-    int send_value = 1;
-    int recv_value = 1;
+        /* getopt_long stores the option index here. */
+        int option_index = 0;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+        c = getopt_long(argc, argv, reprompi_sync_opts_str, reprompi_sync_long_options,
+                &option_index);
 
-    nrounds = ceil(log2((double) np));
+        /* Detect the end of the options. */
+        if (c == -1)
+            break;
 
-    for (i = 0; i < nrounds; i++) {
-        send_rank = (my_rank + (1<<i)) % np;
-        recv_rank = (my_rank - (1 << i) + np) % np;
+        switch (c) {
+        case REPROMPI_ARGS_BBARRIER_SKEW: /* number of barriers used to measure the exit skew */
+            opts_p->bbarrier_skew_nrep = atol(optarg);
+            break;
+        case '?':
+            break;
+        }
+    }
 
-        //printf("[%d] Sending from %d to %d; receive from %d\n", i, my_rank, send_rank, recv_rank);
-        MPI_Sendrecv(&send_value, 1, MPI_INT, send_rank, 0,
-                &recv_value, 1, MPI_INT, recv_rank, 0,
-                MPI_COMM_WORLD, &status);
+    if (opts_p->bbarrier_skew_nrep < 0) {
+        reprompib_print_error_and_exit("Invalid number of barriers for the exit skew (should be positive)");
     }
 
+    optind = 1; // reset optind to enable option re-parsing
+    opterr = 1; // reset opterr to catch invalid options
+}
+
+void bbarrier_init_synchronization(void) {
+    MPI_Barrier(MPI_COMM_WORLD);
 }
 
 
 void bbarrier_start_synchronization(void) {
-    dissemination_barrier();
+    reprompi_bbarrier();
 #ifdef ENABLE_DOUBLE_BARRIER
-    dissemination_barrier();
+    reprompi_bbarrier();
 #endif
 }
 
@@ -80,12 +171,27 @@ void bbarrier_stop_synchronization(void) {
 }
 
 void bbarrier_cleanup_synchronization_module(void) {
+    reprompi_bbarrier_free();
+    reprompi_sync_pingpong_cleanup();
 }
 
 void bbarrier_print_sync_parameters(FILE* f) {
+    int type;
+
     fprintf(f, "#@sync=BBarrier\n");
+    fprintf(f, "#@bbarrier=%s\n", reprompi_get_bbarrier_name(reprompi_bbarrier_get_type()));
 #ifdef ENABLE_DOUBLE_BARRIER
     fprintf(f, "#@doublebarrier=true\n");
 #endif
+    if (skew_measured) {
+        fprintf(f, "#@bbarrier_skew_nbarriers=%ld\n", skew_nrep);
+        for (type = 0; type < REPROMPI_N_BBARRIER_TYPES; type++) {
+            const char* name = reprompi_get_bbarrier_name(type);
+            fprintf(f, "#@bbarrier_skew_%s_min_s=%.10f\n", name, skew_summary[type].min);
+            fprintf(f, "#@bbarrier_skew_%s_median_s=%.10f\n", name, skew_summary[type].median);
+            fprintf(f, "#@bbarrier_skew_%s_p95_s=%.10f\n", name, skew_summary[type].p95);
+            fprintf(f, "#@bbarrier_skew_%s_max_s=%.10f\n", name, skew_summary[type].max);
+        }
+    }
 }
 
@@ -25,6 +25,7 @@
 #define BBARRIER_SYNC_H_
 
 #include "reprompi_bench/sync/sync_info.h"
+#include "bbarrier_algorithms.h"
 
 void bbarrier_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
 void bbarrier_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p);
@@ -39,6 +40,4 @@ double bbarrier_get_normalized_time(double local_time);
 
 void bbarrier_print_sync_parameters(FILE* f);
 
-void dissemination_barrier(void);
-
 #endif /* BBARRIER_SYNC_H_ */
@@ -0,0 +1,558 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <gsl/gsl_fit.h>
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+#include "hca_drift_model.h"
+
+static const char* const drift_model_names[] = {
+        [HCA_DRIFT_MODEL_LINEAR] = "linear",
+        [HCA_DRIFT_MODEL_THEILSEN] = "theilsen",
+        [HCA_DRIFT_MODEL_QUADRATIC] = "quadratic",
+        [HCA_DRIFT_MODEL_PIECEWISE] = "piecewise",
+        [HCA_DRIFT_MODEL_RANSAC] = "ransac",
+        [HCA_DRIFT_MODEL_AUTO] = "auto"
+};
+static const int N_DRIFT_MODELS = 6;
+
+// the leave-one-out prediction error is estimated on at most this many points
+static const int MAX_LOO_POINTS = 100;
+
+// a breakpoint needs this many points on each side
+static const int MIN_SEGMENT_POINTS = 2;
+
+// RANSAC tries all pairs of points up to this number of candidate lines, otherwise random pairs
+static const int MAX_RANSAC_TRIALS = 500;
+// points within this many (robust) standard deviations of a candidate line are inliers
+static const double RANSAC_INLIER_THRESHOLD = 3.0;
+
+
+static double basis(const reprompi_hca_drift_fit_t* fit, const int j, const double u) {
+    double d;
+
+    if (j == 0) {
+        return 1.0;
+    }
+    if (j == 1) {
+        return u;
+    }
+    if (fit->type == HCA_DRIFT_MODEL_QUADRATIC) {
+        return u * u;
+    }
+    d = u - fit->knots[j - 2];
+    return (d > 0) ? d : 0.0;
+}
+
+
+static double eval_scaled(const reprompi_hca_drift_fit_t* fit, const double u) {
+    int j;
+    double value = 0;
+
+    for (j = 0; j < fit->n_coeffs; j++) {
+        value += fit->coeffs[j] * basis(fit, j, u);
+    }
+    return value;
+}
+
+
+/* solve the normal equations of the least-squares problem with Gaussian elimination */
+static int fit_least_squares(reprompi_hca_drift_fit_t* fit, const double* u, const double* y, const int n) {
+    double a[HCA_DRIFT_MAX_COEFFS][HCA_DRIFT_MAX_COEFFS];
+    double b[HCA_DRIFT_MAX_COEFFS];
+    double phi[HCA_DRIFT_MAX_COEFFS];
+    double max_diag = 0, tmp, factor;
+    int i, j, l, pivot;
+    const int k = fit->n_coeffs;
+
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < k; j++) {
+            phi[j] = basis(fit, j, u[i]);
+        }
+        for (j = 0; j < k; j++) {
+            for (l = 0; l < k; l++) {
+                a[j][l] += phi[j] * phi[l];
+            }
+            b[j] += phi[j] * y[i];
+        }
+    }
+    for (j = 0; j < k; j++) {
+        if (a[j][j] > max_diag) {
+            max_diag = a[j][j];
+        }
+    }
+
+    for (j = 0; j < k; j++) {
+        pivot = j;
+        for (i = j + 1; i < k; i++) {
+            if (fabs(a[i][j]) > fabs(a[pivot][j])) {
+                pivot = i;
+            }
+        }
+        if (fabs(a[pivot][j]) <= 1e-12 * max_diag) {
+            return 1;
+        }
+        if (pivot != j) {
+            for (l = 0; l < k; l++) {
+                tmp = a[j][l];
+                a[j][l] = a[pivot][l];
+                a[pivot][l] = tmp;
+            }
+            tmp = b[j];
+            b[j] = b[pivot];
+            b[pivot] = tmp;
+        }
+        for (i = j + 1; i < k; i++) {
+            factor = a[i][j] / a[j][j];
+            for (l = j; l < k; l++) {
+                a[i][l] -= factor * a[j][l];
+            }
+            b[i] -= factor * b[j];
+        }
+    }
+
+    for (j = k - 1; j >= 0; j--) {
+        tmp = b[j];
+        for (l = j + 1; l < k; l++) {
+            tmp -= a[j][l] * fit->coeffs[l];
+        }
+        fit->coeffs[j] = tmp / a[j][j];
+    }
+    return 0;
+}
+
+
+static int fit_theilsen(reprompi_hca_drift_fit_t* fit, const double* u, const double* y, const int n) {
+    double* values;
+    double slope;
+    int i, j, m;
+
+    values = (double*) malloc(((size_t)n * (n - 1) / 2 + n) * sizeof(double));
+    m = 0;
+    for (i = 0; i < n; i++) {
+        for (j = i + 1; j < n; j++) {
+            if (u[j] != u[i]) {
+                values[m++] = (y[j] - y[i]) / (u[j] - u[i]);
+            }
+        }
+    }
+    if (m == 0) {
+        free(values);
+        return 1;
+    }
+    gsl_sort(values, 1, m);
+    slope = gsl_stats_median_from_sorted_data(values, 1, m);
+
+    for (i = 0; i < n; i++) {
+        values[i] = y[i] - slope * u[i];
+    }
+    gsl_sort(values, 1, n);
+    fit->coeffs[0] = gsl_stats_median_from_sorted_data(values, 1, n);
+    fit->coeffs[1] = slope;
+
+    free(values);
+    return 0;
+}
+
+
+/*
+ * RANSAC: the line through two of the points that has the most points within
+ * RANSAC_INLIER_THRESHOLD robust standard deviations (estimated from the
+ * residuals of the Theil-Sen line), refitted with least squares on its inliers.
+ * The random pairs come from a fixed seed, so that all runs fit the same line.
+ */
+static int fit_ransac(reprompi_hca_drift_fit_t* fit, const double* u, const double* y, const int n) {
+    double *abs_res, *u_in, *y_in;
+    double threshold, slope, intercept;
+    double cov00, cov01, cov11, sumsq;
+    int i, j, k, trial, n_trials, n_in, best_n_in = 0;
+    int best_i = 0, best_j = 1;
+    int all_pairs;
+    unsigned int seed = 1;
+    int ret;
+
+    if (n < 3) {
+        return fit_theilsen(fit, u, y, n);
+    }
+    if (fit_theilsen(fit, u, y, n) != 0) {
+        return 1;
+    }
+
+    abs_res = (double*) malloc(n * sizeof(double));
+    for (i = 0; i < n; i++) {
+        abs_res[i] = fabs(y[i] - (fit->coeffs[0] + fit->coeffs[1] * u[i]));
+    }
+    gsl_sort(abs_res, 1, n);
+    threshold = RANSAC_INLIER_THRESHOLD * 1.4826 * gsl_stats_median_from_sorted_data(abs_res, 1, n);
+    free(abs_res);
+
+    all_pairs = ((long)n * (n - 1) / 2 <= MAX_RANSAC_TRIALS);
+    n_trials = all_pairs ? n * (n - 1) / 2 : MAX_RANSAC_TRIALS;
+    i = 0;
+    j = 0;
+    for (trial = 0; trial < n_trials; trial++) {
+        if (all_pairs) {
+            j++;
+            if (j >= n) {
+                i++;
+                j = i + 1;
+            }
+        } else {
+            seed = seed * 1103515245u + 12345u;
+            i = (int)((seed >> 8) % (unsigned int)n);
+            seed = seed * 1103515245u + 12345u;
+            j = (int)((seed >> 8) % (unsigned int)n);
+        }
+        if (u[i] == u[j]) {
+            continue;
+        }
+        slope = (y[j] - y[i]) / (u[j] - u[i]);
+        intercept = y[i] - slope * u[i];
+
+        n_in = 0;
+        for (k = 0; k < n; k++) {
+            if (fabs(y[k] - (intercept + slope * u[k])) <= threshold) {
+                n_in++;
+            }
+        }
+        if (n_in > best_n_in) {
+            best_n_in = n_in;
+            best_i = i;
+            best_j = j;
+        }
+    }
+    if (best_n_in < 2) {
+        // the Theil-Sen line is kept
+        return 0;
+    }
+
+    slope = (y[best_j] - y[best_i]) / (u[best_j] - u[best_i]);
+    intercept = y[best_i] - slope * u[best_i];
+    u_in = (double*) malloc(n * sizeof(double));
+    y_in = (double*) malloc(n * sizeof(double));
+    n_in = 0;
+    for (i = 0; i < n; i++) {
+        if (fabs(y[i] - (intercept + slope * u[i])) <= threshold) {
+            u_in[n_in] = u[i];
+            y_in[n_in] = y[i];
+            n_in++;
+        }
+    }
+    ret = (gsl_fit_linear(u_in, 1, y_in, 1, n_in, &(fit->coeffs[0]), &(fit->coeffs[1]),
+            &cov00, &cov01, &cov11, &sumsq) != 0);
+    free(u_in);
+    free(y_in);
+    return ret;
+}
+
+
+/* fit the coefficients of a model with known type and breakpoints */
+static int fit_coefficients(reprompi_hca_drift_fit_t* fit, const double* u, const double* y, const int n) {
+    double cov00, cov01, cov11, sumsq;
+
+    if (n < fit->n_coeffs) {
+        return 1;
+    }
+    switch (fit->type) {
+    case HCA_DRIFT_MODEL_LINEAR:
+        return (gsl_fit_linear(u, 1, y, 1, n, &(fit->coeffs[0]), &(fit->coeffs[1]),
+                &cov00, &cov01, &cov11, &sumsq) != 0);
+    case HCA_DRIFT_MODEL_THEILSEN:
+        return fit_theilsen(fit, u, y, n);
+    case HCA_DRIFT_MODEL_RANSAC:
+        return fit_ransac(fit, u, y, n);
+    default:
+        return fit_least_squares(fit, u, y, n);
+    }
+}
+
+
+static double sum_squared_residuals(const reprompi_hca_drift_fit_t* fit, const double* u, const double* y,
+        const int n) {
+    int i;
+    double d, sum = 0;
+
+    for (i = 0; i < n; i++) {
+        d = y[i] - eval_scaled(fit, u[i]);
+        sum += d * d;
+    }
+    return sum;
+}
+
+
+static double bic(const double sse, const int n, const int nparams) {
+    return n * log(sse / n + 1e-40) + nparams * log((double)n);
+}
+
+
+/*
+ * Greedily add the breakpoint that reduces the squared residuals the most,
+ * as long as this improves the Bayesian information criterion
+ * (a breakpoint counts as two parameters, its position and its slope change).
+ */
+static int fit_piecewise(reprompi_hca_drift_fit_t* fit, const double* u, const double* y, const int n) {
+    reprompi_hca_drift_fit_t trial, best_trial;
+    double best_bic, best_sse, sse;
+    int i, j, n_left, n_right, is_knot;
+
+    fit->n_knots = 0;
+    fit->n_coeffs = 2;
+    if (fit_coefficients(fit, u, y, n) != 0) {
+        return 1;
+    }
+    best_bic = bic(sum_squared_residuals(fit, u, y, n), n, 2);
+
+    while (fit->n_knots < HCA_DRIFT_MAX_KNOTS) {
+        best_sse = -1;
+        for (i = 0; i < n; i++) {
+            is_knot = 0;
+            for (j = 0; j < fit->n_knots; j++) {
+                if (fit->knots[j] == u[i]) {
+                    is_knot = 1;
+                }
+            }
+            n_left = n_right = 0;
+            for (j = 0; j < n; j++) {
+                if (u[j] < u[i]) {
+                    n_left++;
+                } else if (u[j] > u[i]) {
+                    n_right++;
+                }
+            }
+            if (is_knot || n_left < MIN_SEGMENT_POINTS || n_right < MIN_SEGMENT_POINTS) {
+                continue;
+            }
+
+            trial = *fit;
+            trial.knots[trial.n_knots++] = u[i];
+            trial.n_coeffs++;
+            if (fit_coefficients(&trial, u, y, n) != 0) {
+                continue;
+            }
+            sse = sum_squared_residuals(&trial, u, y, n);
+            if (best_sse < 0 || sse < best_sse) {
+                best_sse = sse;
+                best_trial = trial;
+            }
+        }
+
+        if (best_sse < 0 || bic(best_sse, n, 2 + 2 * best_trial.n_knots) >= best_bic) {
+            break;
+        }
+        best_bic = bic(best_sse, n, 2 + 2 * best_trial.n_knots);
+        *fit = best_trial;
+    }
+    return 0;
+}
+
+
+static double prediction_error(const reprompi_hca_drift_fit_t* fit, const double* u, const double* y,
+        const int n) {
+    reprompi_hca_drift_fit_t loo_fit;
+    double *u_loo, *y_loo;
+    double d, sum = 0;
+    int i, j, m, step;
+    int count = 0;
+
+    if (n <= fit->n_coeffs) {
+        return -1;
+    }
+
+    u_loo = (double*) malloc((n - 1) * sizeof(double));
+    y_loo = (double*) malloc((n - 1) * sizeof(double));
+    step = (n + MAX_LOO_POINTS - 1) / MAX_LOO_POINTS;
+
+    for (i = 0; i < n; i += step) {
+        m = 0;
+        for (j = 0; j < n; j++) {
+            if (j != i) {
+                u_loo[m] = u[j];
+                y_loo[m] = y[j];
+                m++;
+            }
+        }
+        // the breakpoints are kept at the positions found on all points
+        loo_fit = *fit;
+        if (fit_coefficients(&loo_fit, u_loo, y_loo, m) == 0) {
+            d = y[i] - eval_scaled(&loo_fit, u[i]);
+            sum += d * d;
+            count++;
+        }
+    }
+
+    free(u_loo);
+    free(y_loo);
+    if (count == 0) {
+        return -1;
+    }
+    return sqrt(sum / count);
+}
+
+
+static int fit_model(const reprompi_hca_drift_model_t type, const double* u, const double* y, const int n,
+        reprompi_hca_drift_fit_t* fit) {
+    int ret;
+
+    fit->type = type;
+    fit->n_knots = 0;
+    switch (type) {
+    case HCA_DRIFT_MODEL_QUADRATIC:
+        fit->n_coeffs = 3;
+        ret = fit_coefficients(fit, u, y, n);
+        break;
+    case HCA_DRIFT_MODEL_PIECEWISE:
+        ret = fit_piecewise(fit, u, y, n);
+        break;
+    default:
+        fit->n_coeffs = 2;
+        ret = fit_coefficients(fit, u, y, n);
+        break;
+    }
+    if (ret != 0) {
+        return ret;
+    }
+
+    fit->residual_rms = sqrt(sum_squared_residuals(fit, u, y, n) / n);
+    fit->prediction_error = prediction_error(fit, u, y, n);
+    return 0;
+}
+
+
+int reprompi_hca_drift_fit(const reprompi_hca_drift_model_t type, const int linear_only,
+        const double* x, const double* y, const int n, reprompi_hca_drift_fit_t* fit) {
+    reprompi_hca_drift_fit_t candidate;
+    reprompi_hca_drift_model_t t;
+    double *u;
+    double xmin, xmax;
+    int i;
+    int ret = 1;
+
+    if (n < 2) {
+        return 1;
+    }
+
+    // fit on times scaled to [0,1] to keep the normal equations well conditioned
+    xmin = xmax = x[0];
+    for (i = 1; i < n; i++) {
+        if (x[i] < xmin) {
+            xmin = x[i];
+        }
+        if (x[i] > xmax) {
+            xmax = x[i];
+        }
+    }
+    memset(fit, 0, sizeof(reprompi_hca_drift_fit_t));
+    fit->x0 = xmin;
+    fit->x_scale = (xmax > xmin) ? (xmax - xmin) : 1.0;
+
+    u = (double*) malloc(n * sizeof(double));
+    for (i = 0; i < n; i++) {
+        u[i] = (x[i] - fit->x0) / fit->x_scale;
+    }
+
+    if (type == HCA_DRIFT_MODEL_AUTO) {
+        for (t = HCA_DRIFT_MODEL_LINEAR; t < HCA_DRIFT_MODEL_AUTO; t++) {
+            if (linear_only && (t == HCA_DRIFT_MODEL_QUADRATIC || t == HCA_DRIFT_MODEL_PIECEWISE)) {
+                continue;
+            }
+            candidate = *fit;
+            if (fit_model(t, u, y, n, &candidate) != 0) {
+                continue;
+            }
+            // models without a prediction error are only used if nothing else fits
+            if (ret != 0 || (candidate.prediction_error >= 0
+                    && (fit->prediction_error < 0 || candidate.prediction_error < fit->prediction_error))) {
+                *fit = candidate;
+                ret = 0;
+            }
+        }
+    } else if (linear_only && (type == HCA_DRIFT_MODEL_QUADRATIC || type == HCA_DRIFT_MODEL_PIECEWISE)) {
+        ret = fit_model(HCA_DRIFT_MODEL_LINEAR, u, y, n, fit);
+    } else {
+        ret = fit_model(type, u, y, n, fit);
+    }
+
+    free(u);
+    return ret;
+}
+
+
+double reprompi_hca_drift_eval(const reprompi_hca_drift_fit_t* fit, const double x) {
+    return eval_scaled(fit, (x - fit->x0) / fit->x_scale);
+}
+
+
+double reprompi_hca_drift_eval_nonlinear(const reprompi_hca_drift_fit_t* fit, const double x) {
+    int j;
+    double u;
+    double value = 0;
+
+    u = (x - fit->x0) / fit->x_scale;
+    for (j = 2; j < fit->n_coeffs; j++) {
+        value += fit->coeffs[j] * basis(fit, j, u);
+    }
+    return value;
+}
+
+
+int reprompi_hca_drift_is_nonlinear(const reprompi_hca_drift_fit_t* fit) {
+    return (fit->n_coeffs > 2);
+}
+
+
+void reprompi_hca_drift_get_line(const reprompi_hca_drift_fit_t* fit, double* intercept, double* slope) {
+    *slope = fit->coeffs[1] / fit->x_scale;
+    *intercept = fit->coeffs[0] - fit->coeffs[1] * fit->x0 / fit->x_scale;
+}
+
+
+const char* reprompi_get_hca_drift_model_name(const reprompi_hca_drift_model_t type) {
+    if (type < 0 || type >= N_DRIFT_MODELS) {
+        return "unknown";
+    }
+    return drift_model_names[type];
+}
+
+
+/* returns 0 on success and 1 if the name does not match any model */
+int reprompi_parse_hca_drift_model(const char* name, reprompi_hca_drift_model_t* type) {
+    int i;
+
+    if (name == NULL) {
+        return 1;
+    }
+    for (i = 0; i < N_DRIFT_MODELS; i++) {
+        if (strcmp(name, drift_model_names[i]) == 0) {
+            *type = (reprompi_hca_drift_model_t)i;
+            return 0;
+        }
+    }
+    return 1;
+}
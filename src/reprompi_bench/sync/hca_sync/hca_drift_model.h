@@ -0,0 +1,74 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef HCA_DRIFT_MODEL_H_
+#define HCA_DRIFT_MODEL_H_
+
+#include "reprompi_bench/sync/sync_info.h"
+
+#define HCA_DRIFT_MAX_KNOTS 3
+#define HCA_DRIFT_MAX_COEFFS (3 + HCA_DRIFT_MAX_KNOTS)
+
+/*
+ * Model of the clock offset y as a function of the local time x.
+ * With u = (x - x0) / x_scale, the model is
+ *   c[0] + c[1] * u                                     (linear, Theil-Sen, RANSAC)
+ *   c[0] + c[1] * u + c[2] * u^2                        (quadratic)
+ *   c[0] + c[1] * u + sum_k c[2+k] * max(0, u - knot_k) (piecewise)
+ */
+typedef struct {
+    reprompi_hca_drift_model_t type;    /* never HCA_DRIFT_MODEL_AUTO after a fit */
+    double x0;
+    double x_scale;
+    int n_coeffs;
+    double coeffs[HCA_DRIFT_MAX_COEFFS];
+    int n_knots;
+    double knots[HCA_DRIFT_MAX_KNOTS];
+
+    double residual_rms;        /* root mean square of the fit residuals */
+    double prediction_error;    /* root mean square leave-one-out prediction error */
+} reprompi_hca_drift_fit_t;
+
+/*
+ * Fit a model of the given type to the n points (x[i], y[i]).
+ * With HCA_DRIFT_MODEL_AUTO, all models are fitted and the one with the lowest
+ * prediction error is returned. If linear_only is set, the quadratic and
+ * piecewise models are replaced by the least-squares line.
+ * Returns 0 on success and 1 if there are not enough points for the model.
+ */
+int reprompi_hca_drift_fit(const reprompi_hca_drift_model_t type, const int linear_only,
+        const double* x, const double* y, const int n, reprompi_hca_drift_fit_t* fit);
+
+double reprompi_hca_drift_eval(const reprompi_hca_drift_fit_t* fit, const double x);
+
+/* value of the quadratic or piecewise terms only, which are not part of the line */
+double reprompi_hca_drift_eval_nonlinear(const reprompi_hca_drift_fit_t* fit, const double x);
+int reprompi_hca_drift_is_nonlinear(const reprompi_hca_drift_fit_t* fit);
+
+/* linear part of the model as intercept + slope * x */
+void reprompi_hca_drift_get_line(const reprompi_hca_drift_fit_t* fit, double* intercept, double* slope);
+
+const char* reprompi_get_hca_drift_model_name(const reprompi_hca_drift_model_t type);
+int reprompi_parse_hca_drift_model(const char* name, reprompi_hca_drift_model_t* type);
+
+#endif /* HCA_DRIFT_MODEL_H_ */
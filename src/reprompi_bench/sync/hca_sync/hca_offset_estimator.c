@@ -0,0 +1,197 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+#include "hca_offset_estimator.h"
+
+static const char* const offset_estimator_names[] = {
+        [HCA_OFFSET_ESTIMATOR_MEDIAN] = "median",
+        [HCA_OFFSET_ESTIMATOR_MINRTT] = "minrtt",
+        [HCA_OFFSET_ESTIMATOR_HUBER] = "huber"
+};
+static const int N_OFFSET_ESTIMATORS = 3;
+
+// tuning constant of the Huber estimator (95% efficiency for normal data)
+static const double HUBER_K = 1.345;
+static const int HUBER_MAX_ITERATIONS = 20;
+
+// scale factor from the median absolute deviation to the standard deviation of normal data
+static const double MAD_TO_SD = 1.4826;
+
+
+/* median absolute deviation from the median of the values */
+static double median_and_mad(const double* values, const int n, double* median) {
+    double* sorted;
+    int i;
+    double mad;
+
+    sorted = (double*) malloc(n * sizeof(double));
+    memcpy(sorted, values, n * sizeof(double));
+    gsl_sort(sorted, 1, n);
+    *median = gsl_stats_median_from_sorted_data(sorted, 1, n);
+
+    for (i = 0; i < n; i++) {
+        sorted[i] = fabs(values[i] - *median);
+    }
+    gsl_sort(sorted, 1, n);
+    mad = gsl_stats_median_from_sorted_data(sorted, 1, n);
+
+    free(sorted);
+    return mad;
+}
+
+
+static double huber_location(const double* values, const int n) {
+    double mu, scale, limit, r, w, sum_w, sum_wy, new_mu;
+    int i, it;
+
+    scale = MAD_TO_SD * median_and_mad(values, n, &mu);
+    if (scale <= 0) {
+        return mu;
+    }
+    limit = HUBER_K * scale;
+
+    for (it = 0; it < HUBER_MAX_ITERATIONS; it++) {
+        sum_w = sum_wy = 0;
+        for (i = 0; i < n; i++) {
+            r = fabs(values[i] - mu);
+            w = (r <= limit) ? 1.0 : limit / r;
+            sum_w += w;
+            sum_wy += w * values[i];
+        }
+        new_mu = sum_wy / sum_w;
+        if (fabs(new_mu - mu) < 1e-3 * scale) {
+            mu = new_mu;
+            break;
+        }
+        mu = new_mu;
+    }
+    return mu;
+}
+
+
+void reprompi_hca_estimate_offset(const reprompi_hca_offset_estimator_t estimator,
+        const double* send_time, const double* recv_time, const double* ref_time, const int n,
+        const double mean_rtt, double* x, double* y) {
+    double *offsets, *sorted;
+    double median;
+    int i, best;
+
+    offsets = (double*) malloc(n * sizeof(double));
+    for (i = 0; i < n; i++) {
+        offsets[i] = recv_time[i] - ref_time[i] - mean_rtt / 2.0;
+    }
+
+    switch (estimator) {
+    case HCA_OFFSET_ESTIMATOR_MINRTT:
+        // NTP-style: the exchange with the smallest round-trip time has the least queuing delay
+        best = 0;
+        for (i = 1; i < n; i++) {
+            if (recv_time[i] - send_time[i] < recv_time[best] - send_time[best]) {
+                best = i;
+            }
+        }
+        *x = recv_time[best];
+        *y = (send_time[best] + recv_time[best]) / 2.0 - ref_time[best];
+        break;
+
+    case HCA_OFFSET_ESTIMATOR_HUBER:
+        *x = gsl_stats_mean(recv_time, 1, n);
+        *y = huber_location(offsets, n);
+        break;
+
+    case HCA_OFFSET_ESTIMATOR_MEDIAN:
+    default:
+        sorted = (double*) malloc(n * sizeof(double));
+        memcpy(sorted, offsets, n * sizeof(double));
+        gsl_sort(sorted, 1, n);
+        // the median has to be one of the offsets, so that it has a matching local time
+        if (n % 2 == 0) {
+            median = gsl_stats_median_from_sorted_data(sorted, 1, n - 1);
+        } else {
+            median = gsl_stats_median_from_sorted_data(sorted, 1, n);
+        }
+        free(sorted);
+
+        *x = 0;
+        *y = 0;
+        for (i = 0; i < n; i++) {
+            if (offsets[i] == median) {
+                *x = recv_time[i];
+                *y = offsets[i];
+                break;
+            }
+        }
+        break;
+    }
+
+    free(offsets);
+}
+
+
+double reprompi_hca_offset_ci_halfwidth(const double* recv_time, const double* ref_time, const int n,
+        const double mean_rtt) {
+    double* offsets;
+    double median, mad;
+    int i;
+
+    offsets = (double*) malloc(n * sizeof(double));
+    for (i = 0; i < n; i++) {
+        offsets[i] = recv_time[i] - ref_time[i] - mean_rtt / 2.0;
+    }
+    mad = median_and_mad(offsets, n, &median);
+    free(offsets);
+
+    return 1.96 * MAD_TO_SD * mad / sqrt((double)n);
+}
+
+
+const char* reprompi_get_hca_offset_estimator_name(const reprompi_hca_offset_estimator_t estimator) {
+    if (estimator < 0 || estimator >= N_OFFSET_ESTIMATORS) {
+        return "unknown";
+    }
+    return offset_estimator_names[estimator];
+}
+
+
+/* returns 0 on success and 1 if the name does not match any estimator */
+int reprompi_parse_hca_offset_estimator(const char* name, reprompi_hca_offset_estimator_t* estimator) {
+    int i;
+
+    if (name == NULL) {
+        return 1;
+    }
+    for (i = 0; i < N_OFFSET_ESTIMATORS; i++) {
+        if (strcmp(name, offset_estimator_names[i]) == 0) {
+            *estimator = (reprompi_hca_offset_estimator_t)i;
+            return 0;
+        }
+    }
+    return 1;
+}
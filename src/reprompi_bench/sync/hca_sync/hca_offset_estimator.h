@@ -0,0 +1,54 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef HCA_OFFSET_ESTIMATOR_H_
+#define HCA_OFFSET_ESTIMATOR_H_
+
+#include "reprompi_bench/sync/sync_info.h"
+
+/* the adaptive mode (--hca-offset-ci) uses at least this many exchanges per fit point */
+#define HCA_OFFSET_MIN_EXCHANGES 5
+
+/*
+ * Estimate one fit point from n exchanges with the reference process:
+ * the client sent at send_time[i], received the reference time ref_time[i]
+ * at recv_time[i] (all local times but ref_time), and mean_rtt is the mean
+ * round-trip time of the pair.
+ * Sets *x to the local time and *y to the offset of the fit point.
+ */
+void reprompi_hca_estimate_offset(const reprompi_hca_offset_estimator_t estimator,
+        const double* send_time, const double* recv_time, const double* ref_time, const int n,
+        const double mean_rtt, double* x, double* y);
+
+/*
+ * Half-width of the 95% confidence interval of the offset estimated from the
+ * first n exchanges, using the median absolute deviation of the offsets as a
+ * robust estimate of their standard deviation.
+ */
+double reprompi_hca_offset_ci_halfwidth(const double* recv_time, const double* ref_time, const int n,
+        const double mean_rtt);
+
+const char* reprompi_get_hca_offset_estimator_name(const reprompi_hca_offset_estimator_t estimator);
+int reprompi_parse_hca_offset_estimator(const char* name, reprompi_hca_offset_estimator_t* estimator);
+
+#endif /* HCA_OFFSET_ESTIMATOR_H_ */
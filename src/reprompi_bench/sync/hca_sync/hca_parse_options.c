@@ -32,6 +32,9 @@
 
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/time_measurement.h"
+#include "hca_drift_model.h"
+#include "hca_offset_estimator.h"
 #include "hca_parse_options.h"
 
 
@@ -72,6 +75,76 @@ void hca_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p)
             opts_p->wait_time_sec = atof(optarg) * 1e-6;
             break;
 
+        case REPROMPI_ARGS_WINSYNC_HYBRID_WAIT: /* sleep until this long (in usec) before the window start, then spin */
+            opts_p->hybrid_wait_spin_sec = atof(optarg) * 1e-6;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_SYNC_CHECK: /* number of ranks whose global clock is validated after each job */
+            opts_p->sync_check_ranks = atoi(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_HCA_TOPOLOGY: /* communication pattern used to learn the clock models */
+            if (reprompi_parse_hca_topology(optarg, &(opts_p->hca_topology)) != 0) {
+              reprompib_print_error_and_exit("Invalid HCA topology (--hca-topology=<linear|binomial|hierarchical>)");
+            }
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_NODE_LEADER_SYNC: /* only node leaders synchronize with the root */
+            opts_p->node_leader_sync = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_NODE_OFFSET_CHECK: /* measure the clock offsets within each node */
+            opts_p->node_offset_check = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_HCA_RESYNC_WINDOWS: /* refresh the clock model every N windows */
+            opts_p->hca_resync_windows = atol(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_HCA_RESYNC_TIME: /* refresh the clock model every T seconds */
+            opts_p->hca_resync_time_sec = atof(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_HCA_DRIFT_MODEL: /* model fitted to the clock offsets */
+            if (reprompi_parse_hca_drift_model(optarg, &(opts_p->hca_drift_model)) != 0) {
+              reprompib_print_error_and_exit("Invalid HCA drift model (--hca-drift-model=<linear|theilsen|quadratic|piecewise|ransac|auto>)");
+            }
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_HCA_OFFSET_ESTIMATOR: /* offset estimated from the exchanges of a fit point */
+            if (reprompi_parse_hca_offset_estimator(optarg, &(opts_p->hca_offset_estimator)) != 0) {
+              reprompib_print_error_and_exit("Invalid HCA offset estimator (--hca-offset-estimator=<median|minrtt|huber>)");
+            }
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_HCA_OFFSET_CI: /* stop the exchanges of a fit point at this confidence interval (in usec) */
+            opts_p->hca_offset_ci_sec = atof(optarg) * 1e-6;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_MODEL_CACHE: /* reuse the clock models across jobs */
+            opts_p->sync_model_cache = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_MODEL_TOLERANCE: /* maximum offset to the root for reusing a clock model (in usec) */
+            opts_p->sync_model_tolerance_sec = atof(optarg) * 1e-6;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_MODEL_FILE: /* file used to save and load the clock models */
+            opts_p->sync_model_file = optarg;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW: /* size the windows from a pilot run and the error rate */
+            opts_p->adaptive_window = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_PILOT: /* number of pilot windows */
+            opts_p->adaptive_window_pilot = atol(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_BATCH: /* number of windows between two window size adjustments */
+            opts_p->adaptive_window_batch = atol(optarg);
+            break;
+
         case '?':
              break;
         }
@@ -81,15 +154,43 @@ void hca_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p)
     if (opts_p->window_size_sec <= 0) {
       reprompib_print_error_and_exit("Invalid window size (should be positive)");
     }
+    if (opts_p->node_leader_sync && !reprompi_is_clock_shared(reprompi_get_clock())) {
+      reprompib_print_error_and_exit("--node-leader-sync requires a clock shared by the processes of a node "
+          "(--clock=<monotonic|monotonic_raw|realtime|RDTSC|RDTSCP>)");
+    }
     if (opts_p->wait_time_sec <= 0) {
       reprompib_print_error_and_exit("Invalid wait time before the first window (should be positive)");
     }
+    if (opts_p->hybrid_wait_spin_sec < 0) {
+      reprompib_print_error_and_exit("Invalid spin time of the hybrid wait (should be positive, or 0 to only spin)");
+    }
+    if (opts_p->sync_check_ranks < 0) {
+      reprompib_print_error_and_exit("Invalid number of ranks to check (should be positive, or 0 to disable the check)");
+    }
+    if (opts_p->hca_offset_ci_sec < 0) {
+      reprompib_print_error_and_exit("Invalid offset confidence interval (should be positive, or 0 to use all exchanges)");
+    }
     if (opts_p->n_fitpoints <= 0) {
       reprompib_print_error_and_exit("Invalid number of fitpoints (should be a positive integer)");
     }
     if (opts_p->n_exchanges <= 0) {
       reprompib_print_error_and_exit("Invalid number of ping-pong exchanges (should be a positive integer)");
     }
+    if (opts_p->hca_resync_windows < 0) {
+      reprompib_print_error_and_exit("Invalid number of windows between model updates (should be a positive integer)");
+    }
+    if (opts_p->hca_resync_time_sec < 0) {
+      reprompib_print_error_and_exit("Invalid time between model updates (should be positive)");
+    }
+    if (opts_p->sync_model_tolerance_sec <= 0) {
+      reprompib_print_error_and_exit("Invalid tolerance for reusing the clock models (should be positive)");
+    }
+    if (opts_p->adaptive_window_pilot <= 0) {
+      reprompib_print_error_and_exit("Invalid number of pilot windows (should be a positive integer)");
+    }
+    if (opts_p->adaptive_window_batch <= 0) {
+      reprompib_print_error_and_exit("Invalid number of windows per batch (should be a positive integer)");
+    }
 
 
     optind = 1;	// reset optind to enable option re-parsing
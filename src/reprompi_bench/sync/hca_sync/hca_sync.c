@@ -28,22 +28,38 @@
 #include <math.h>
 #include <limits.h>
 #include "mpi.h"
-#include <gsl/gsl_statistics.h>
-#include <gsl/gsl_fit.h>
-#include <gsl/gsl_sort.h>
 
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/time_measurement.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/node_sync.h"
+#include "reprompi_bench/sync/sync_model_cache.h"
+#include "reprompi_bench/sync/adaptive_window.h"
+#include "reprompi_bench/sync/sync_pingpong.h"
+#include "reprompi_bench/sync/sync_wait.h"
+#include "reprompi_bench/sync/sync_check.h"
+#include "hca_drift_model.h"
+#include "hca_offset_estimator.h"
 #include "hca_parse_options.h"
 #include "hca_sync.h"
 
 const int HCA_WARMUP_ROUNDS = 5;
+// upper bound for the ping-pongs per pair used by the model updates
+static const int HCA_RESYNC_MAX_PINGPONGS = 10;
+
+// sent by the client instead of a ping when it needs no more exchanges for the current fit point
+enum {
+    HCA_FITPOINT_DONE_TAG = 1
+};
 
 
 static double start_sync = 0;       /* current window start timestamp (global time) */
 static int* invalid;
+static double* start_errors;        /* start_errors[i] is the time between the start of window i and the end of the wait (global time) */
+static double* window_slack;        /* window_slack[i] is the time left in window i after the measurement, negative if it expired (global time) */
 static int repetition_counter = 0;  /* current repetition index */
+static double last_resync_start = 0;    /* start of the first window after the last model update (global time) */
+static reprompi_adaptive_window_t adaptive_window;
 
 
 double initial_timestamp = 0;
@@ -59,185 +75,79 @@ typedef struct {
 } lm_t;
 
 lm_t lm;
+static int model_available = 0;     /* lm (and initial_timestamp) hold a model learned or loaded before */
 
+// incremental model updates: fit of the offsets of the learned model (learned_lm)
+// to the root over the update points, using the drift model given by --hca-drift-model
+static lm_t learned_lm;
+static double *update_x = NULL, *update_y = NULL;
+static long n_update_points = 0;
+static long max_update_points = 0;
+static reprompi_hca_drift_fit_t drift_fit;
+static int drift_nonlinear = 0;     /* drift_fit has quadratic or piecewise terms, which are not part of lm */
 
+// largest residual and prediction error of the pairwise fits learned by this process
+static double fit_residual_max, fit_pred_err_max;
+// number of exchanges and fit points measured by this process (reported with --hca-offset-ci)
+static long n_exchanges_done, n_fitpoints_done;
 
-enum {
-    Number_ping_pongs1 = 100,
-    Minimum_ping_pongs1 = 8
-};
 
 
 inline double hca_get_adjusted_time(void) {
     return get_time() - initial_timestamp;
 }
 
+double hca_ticks_to_adjusted_time(const reprompi_ticks_t ticks) {
+    return ticks_to_sec(ticks) - initial_timestamp;
+}
+
 
 inline static lm_t merge_linear_models(lm_t lm1, lm_t lm2) {
     lm_t new_model;
 
-    new_model.intercept = 0;
+    // the merged intercept is only meaningful for the tree-based topologies;
+    // the linear topology recomputes all intercepts against the root afterwards
     new_model.slope = lm1.slope + lm2.slope - lm1.slope * lm2.slope;
-#ifdef ENABLE_LOGP_SYNC         // need to merge previously computed intercepts
     new_model.intercept = lm1.intercept + lm2.intercept - lm2.intercept * lm1.slope;
-#endif
 
     return new_model;
 }
 
-static double ping_pong_skampi(int p1, int p2)
-{
-    int i, other_global_id;
-    double s_now, s_last, t_last, t_now;
-    double td_min, td_max;
-    double invalid_time = -1.0;
-    MPI_Status status;
-    static double *ping_pong_min_time;
-    int pp_tag = 43;
-    double offset = 0;
-
-    int my_rank, np;
-
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
-
-    ping_pong_min_time = (double*)malloc(np * sizeof(double));
-    for( i = 0; i < np; i++) ping_pong_min_time[i] = -1.0;
-
-
-    /* I had to unroll the main loop because I didn't find a portable way
-     to define the initial td_min and td_max with INFINITY and NINFINITY */
-    if( my_rank == p1 ) {
-        other_global_id = p2;
-
-        s_last = hca_get_adjusted_time();
-        MPI_Send(&s_last, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-        MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD, &status);
-        s_now = hca_get_adjusted_time();
-        MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-
-
-        td_min = t_last - s_now;
-        td_max = t_last - s_last;
-
-
-    } else {
-        other_global_id = p1;
-
-        MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD, &status);
-        t_last = hca_get_adjusted_time();
-        MPI_Send(&t_last, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD);
-        MPI_Recv(&s_now, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD, &status);
-        t_now = hca_get_adjusted_time();
-
-
-        td_min = s_last - t_last;
-        td_min = repro_max(td_min, s_now - t_now);
-
-        td_max = s_now - t_last;
-    }
-
-
-    if( my_rank == p1 ) {
-        i = 1;
-        while( 1 ) {
-
-            MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD, &status);
-            if( t_last < 0.0 ) break;
-
-            s_last = s_now;
-            s_now = hca_get_adjusted_time();
-
-            td_min = repro_max(td_min, t_last - s_now);
-            td_max = repro_min(td_max, t_last - s_last);
-
-            if( ping_pong_min_time[other_global_id] >= 0.0  &&
-                    i >= Minimum_ping_pongs1 &&
-                    s_now - s_last < ping_pong_min_time[other_global_id]*1.10 ) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-                break;
-            }
-            i++;
-            if( i == Number_ping_pongs1 ) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-                break;
-            }
-            MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-
-        }
-    } else {
-        i = 1;
-        while( 1 ) {
-            MPI_Send(&t_now, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD);
-            MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD, &status);
-            t_last = t_now;
-            t_now = hca_get_adjusted_time();
-
-            if( s_last < 0.0 ) break;
-
-            td_min = repro_max(td_min, s_last - t_now);
-            td_max = repro_min(td_max, s_last - t_last);
-
-            if( ping_pong_min_time[other_global_id] >= 0.0 &&
-                    i >= Minimum_ping_pongs1 &&
-                    t_now - t_last < ping_pong_min_time[other_global_id]*1.10 ) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD);
-                break;
-            }
-            i++;
-        }
-    }
-
-    if( ping_pong_min_time[other_global_id] < 0.0) {
-        ping_pong_min_time[other_global_id] = td_max-td_min;
-    }
-    else {
-        ping_pong_min_time[other_global_id] = repro_min(ping_pong_min_time[other_global_id], td_max-td_min);
-    }
-    offset = (td_min+td_max)/2.0;
-
-    free(ping_pong_min_time);
-
-    return offset;
-}
-
-
-
-void compute_and_set_intercept(lm_t* lm, int client, int p_ref) {
+void compute_and_set_intercept(lm_t* lm, int client, int p_ref, MPI_Comm comm) {
     int my_rank;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_rank(comm, &my_rank);
 
     if (my_rank == p_ref) {
         //compute intercept with SKaMPI ping-pong
-        ping_pong_skampi(my_rank, client);
+        reprompi_sync_pingpong_skampi_offset(my_rank, client, comm, hca_get_adjusted_time);
     } else
         if (my_rank == client) {
             //compute intercept with SKaMPI ping-pong
             double intercept_time;
-            double offset = -ping_pong_skampi(p_ref, my_rank);
+            double offset = -reprompi_sync_pingpong_skampi_offset(p_ref, my_rank, comm, hca_get_adjusted_time);
 
             intercept_time = hca_get_adjusted_time();
             lm->intercept = (lm->slope) * (-intercept_time) + offset;
         }
 }
 
-void compute_and_set_all_intercepts(lm_t* lm)
+void compute_and_set_all_intercepts(lm_t* lm, MPI_Comm comm)
 {
     int i;
     int my_rank, np;
     int master_rank = 0;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
 
     if (my_rank != master_rank) {
-        compute_and_set_intercept(lm, my_rank, master_rank);
+        compute_and_set_intercept(lm, my_rank, master_rank, comm);
     }
     else {
         for( i = 0; i < np; i++) {
             if (i != master_rank) {
-                compute_and_set_intercept(lm, i, master_rank);
+                compute_and_set_intercept(lm, i, master_rank, comm);
             }
         }
     }
@@ -246,91 +156,14 @@ void compute_and_set_all_intercepts(lm_t* lm)
 
 
 
-void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double *rtt) {
-    int my_rank, np;
-    MPI_Status stat;
-    int i;
-    double tmp;
-    double *rtts = NULL;
-    double mean;
-
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
-
-    if (my_rank == master_rank) {
-        double tstart, tremote;
-
-        /* warm up */
-        for (i = 0; i < HCA_WARMUP_ROUNDS; i++) {
-            tmp = hca_get_adjusted_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD);
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD, &stat);
-        }
-
-        rtts  = (double*) malloc(n_pingpongs * sizeof(double));
-
-        for (i = 0; i < n_pingpongs; i++) {
-            tstart = hca_get_adjusted_time();
-            MPI_Send(&tstart, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD);
-            MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD, &stat);
-            rtts[i] = hca_get_adjusted_time() - tstart;
-        }
-
-    } else if( my_rank == other_rank ) {
-        double tlocal = 0, troot;
-
-        /* warm up */
-        for (i = 0; i < HCA_WARMUP_ROUNDS; i++) {
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD, &stat);
-            tmp = hca_get_adjusted_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD);
-        }
-
-        for (i = 0; i < n_pingpongs; i++) {
-            MPI_Recv(&troot, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD, &stat);
-            tlocal = hca_get_adjusted_time();
-            MPI_Send(&tlocal, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD);
-        }
-    }
-
-    if (my_rank == master_rank) {
-        double upperq;
-        double cutoff_val;
-        double *rtts2;
-        int n_datapoints;
-
-        gsl_sort(rtts, 1, n_pingpongs);
-
-        upperq = gsl_stats_quantile_from_sorted_data (rtts, 1, n_pingpongs, 0.75);
-        cutoff_val = 1.5 * upperq;
-
-        //    printf("cutoff=%.20f\n", cutoff_val);
-        rtts2 = (double*)calloc(n_pingpongs, sizeof(double));
-        n_datapoints = 0;
-        for(i=0; i<n_pingpongs; i++) {
-            if( rtts[i] <= cutoff_val ) {
-                rtts2[i] = rtts[i];
-                n_datapoints = i+1;
-            } else {
-                break;
-            }
-        }
-        mean = gsl_stats_mean(rtts2, 1, n_datapoints);
-
-        free(rtts);
-        free(rtts2);
-
-        MPI_Send(&mean, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD);
-    } else {
-        MPI_Recv(&mean, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD, &stat);
-    }
-
-    *rtt = mean;
+void compute_rtt(int master_rank, int other_rank, const int n_pingpongs, double *rtt, MPI_Comm comm) {
+    *rtt = reprompi_sync_pingpong_mean_rtt(master_rank, other_rank, n_pingpongs, HCA_WARMUP_ROUNDS, comm,
+            hca_get_adjusted_time);
 }
 
 
 lm_t hca_learn_model(const int root_rank, const int other_rank,
-        const reprompi_hca_params_t params, const double my_rtt) {
+        const reprompi_hca_params_t params, const double my_rtt, MPI_Comm comm) {
     int i, j;
     int my_rank, np;
     MPI_Status status;
@@ -339,8 +172,8 @@ lm_t hca_learn_model(const int root_rank, const int other_rank,
     lm.intercept = 0;
     lm.slope = 0;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
 
     if (my_rank == root_rank) {
 
@@ -349,69 +182,67 @@ lm_t hca_learn_model(const int root_rank, const int other_rank,
         for (j = 0; j < params.n_fitpoints; j++) {
 
             for (i = 0; i < params.n_exchanges; i++) {
-                MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD, &status);
+                MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, MPI_ANY_TAG, comm, &status);
+                if (status.MPI_TAG == HCA_FITPOINT_DONE_TAG) {
+                    // the client has a tight enough offset for this fit point
+                    break;
+                }
                 tlocal = hca_get_adjusted_time();
-                MPI_Ssend(&tlocal, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD);
+                MPI_Ssend(&tlocal, 1, MPI_DOUBLE, other_rank, 0, comm);
             }
         }
     } else {
 
-        double *time_var, *local_time, *time_var2;
+        double *send_time, *local_time, *master_time;
         double *xfit, *yfit;
-        double cov00, cov01, cov11, sumsq;
-        int fit;
-        double dummy;
-        double median, master_time;
+        reprompi_hca_drift_fit_t fit;
+        int n_done;
 
-        double mindiff =1e10, mindiff_ts;
-
-        time_var  = (double*) calloc(params.n_exchanges, sizeof(double));
-        time_var2 = (double*) calloc(params.n_exchanges, sizeof(double));
+        send_time = (double*) calloc(params.n_exchanges, sizeof(double));
         local_time = (double*) calloc(params.n_exchanges, sizeof(double));
+        master_time = (double*) calloc(params.n_exchanges, sizeof(double));
 
         xfit = (double*) calloc(params.n_fitpoints, sizeof(double));
         yfit = (double*) calloc(params.n_fitpoints, sizeof(double));
 
         for (j = 0; j < params.n_fitpoints; j++) {
 
+            n_done = 0;
             for (i = 0; i < params.n_exchanges; i++) {
-                dummy = hca_get_adjusted_time();
-                MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, MPI_COMM_WORLD);
-                MPI_Recv(&master_time, 1, MPI_DOUBLE, root_rank, 0, MPI_COMM_WORLD,
+                send_time[i] = hca_get_adjusted_time();
+                MPI_Ssend(&send_time[i], 1, MPI_DOUBLE, root_rank, 0, comm);
+                MPI_Recv(&master_time[i], 1, MPI_DOUBLE, root_rank, 0, comm,
                         &status);
                 local_time[i] = hca_get_adjusted_time();
-                time_var[i] = local_time[i] - master_time - my_rtt / 2.0;
-                time_var2[i] = time_var[i];
-
-                if (time_var[i] < mindiff) {
+                n_done++;
 
-                    mindiff = time_var[i];
-                    mindiff_ts = local_time[i];
+                if (params.offset_ci_sec > 0 && n_done >= HCA_OFFSET_MIN_EXCHANGES && n_done < params.n_exchanges
+                        && reprompi_hca_offset_ci_halfwidth(local_time, master_time, n_done, my_rtt)
+                        <= params.offset_ci_sec) {
+                    MPI_Ssend(&send_time[i], 1, MPI_DOUBLE, root_rank, HCA_FITPOINT_DONE_TAG, comm);
+                    break;
                 }
             }
+            n_exchanges_done += n_done;
+            n_fitpoints_done++;
 
-            gsl_sort(time_var2, 1, params.n_exchanges);
+            reprompi_hca_estimate_offset(params.offset_estimator, send_time, local_time, master_time, n_done,
+                    my_rtt, &xfit[j], &yfit[j]);
+        }
 
-            if( params.n_exchanges % 2 == 0 ) {
-                median = gsl_stats_median_from_sorted_data(time_var2, 1, params.n_exchanges-1);
-            } else {
-                median = gsl_stats_median_from_sorted_data(time_var2, 1, params.n_exchanges);
+        // the models are merged along the tree, so only lines are fitted here
+        if (reprompi_hca_drift_fit(params.drift_model, 1, xfit, yfit, params.n_fitpoints, &fit) == 0) {
+            reprompi_hca_drift_get_line(&fit, &lm.intercept, &lm.slope);
+            if (fit.residual_rms > fit_residual_max) {
+                fit_residual_max = fit.residual_rms;
             }
-
-            for (i = 0; i < params.n_exchanges; i++) {
-                if (time_var[i] == median) {
-                    xfit[j] = local_time[i];
-                    yfit[j] = time_var[i];
-                    break;
-                }
+            if (fit.prediction_error > fit_pred_err_max) {
+                fit_pred_err_max = fit.prediction_error;
             }
         }
-
-        fit = gsl_fit_linear(xfit, 1, yfit, 1, params.n_fitpoints, &lm.intercept,
-                &lm.slope, &cov00, &cov01, &cov11, &sumsq);
-        free(time_var);
-        free(time_var2);
+        free(send_time);
         free(local_time);
+        free(master_time);
         free(xfit);
         free(yfit);
     }
@@ -420,6 +251,10 @@ lm_t hca_learn_model(const int root_rank, const int other_rank,
 }
 
 inline double hca_get_normalized_time(double local_time) {
+    if (drift_nonlinear) {
+        return local_time - (local_time * lm.slope + lm.intercept)
+                - reprompi_hca_drift_eval_nonlinear(&drift_fit, local_time);
+    }
     return local_time- (local_time * lm.slope + lm.intercept);
 }
 
@@ -445,35 +280,62 @@ void hca_init_synchronization_module(const reprompib_sync_options_t parsed_opts,
     parameters.n_exchanges = parsed_opts.n_exchanges;
     parameters.n_fitpoints = parsed_opts.n_fitpoints;
     parameters.wait_time_sec = parsed_opts.wait_time_sec;
+    parameters.hybrid_wait_spin_sec = parsed_opts.hybrid_wait_spin_sec;
+    parameters.sync_check_ranks = parsed_opts.sync_check_ranks;
+    parameters.output_file = parsed_opts.output_file;
     parameters.window_size_sec = parsed_opts.window_size_sec;
+    parameters.topology = parsed_opts.hca_topology;
+    parameters.node_leader_sync = parsed_opts.node_leader_sync;
+    parameters.node_offset_check = parsed_opts.node_offset_check;
+    parameters.model_cache = parsed_opts.sync_model_cache;
+    parameters.model_tolerance_sec = parsed_opts.sync_model_tolerance_sec;
+    parameters.model_file = parsed_opts.sync_model_file;
     parameters.n_rep = nrep;
 
+    parameters.drift_model = parsed_opts.hca_drift_model;
+    parameters.offset_estimator = parsed_opts.hca_offset_estimator;
+    parameters.offset_ci_sec = parsed_opts.hca_offset_ci_sec;
+    parameters.resync_windows = parsed_opts.hca_resync_windows;
+    parameters.resync_time_sec = parsed_opts.hca_resync_time_sec;
     invalid  = (int*)calloc(parameters.n_rep, sizeof(int));
     for(i = 0; i < parameters.n_rep; i++)
     {
         invalid[i] = 0;
     }
+    start_errors = (double*)calloc(parameters.n_rep, sizeof(double));
+    window_slack = (double*)calloc(parameters.n_rep, sizeof(double));
     repetition_counter = 0;
+    reprompi_adaptive_window_init(&adaptive_window, &parsed_opts);
 
-    initial_timestamp = get_time();
+    // a cached model is only valid with the timestamp it was learned with
+    if (!(parameters.model_cache && model_available)) {
+        initial_timestamp = get_time();
+    }
 }
 
 
 
-void hca_synchronize_clocks(void)
+/*
+ * Learn the clock models of all processes in comm relative to rank 0 of comm
+ * along a binomial tree and return the model of the calling process.
+ * With the linear topology only the slopes are propagated along the tree and
+ * the intercepts are computed afterwards against rank 0, one process at a time.
+ */
+static lm_t hca_learn_models_on_comm(MPI_Comm comm, const reprompi_hca_topology_t topology)
 {
     int my_rank, nprocs;
     int i, j, p;
 
     int master_rank = 0;
-    double *rtts_s;
     int n_pingpongs = 1000;
     int max_power_two, nrounds_step1;
     lm_t *linear_models, *tmp_linear_models;
+    lm_t my_lm;
     int running_power;
     int other_rank;
     double current_rtt;
     int nb_lm_to_comm;
+    int merge_intercepts = (topology != HCA_TOPOLOGY_LINEAR);
 
     MPI_Datatype dtype[2] = { MPI_DOUBLE, MPI_DOUBLE };
     int blocklen[2] =  { 1, 1 };
@@ -487,10 +349,14 @@ void hca_synchronize_clocks(void)
     MPI_Comm step_two_comm;
 
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &nprocs);
 
-    rtts_s = (double*)calloc(nprocs, sizeof(double));
+    my_lm.intercept = 0;
+    my_lm.slope = 0;
+    if (nprocs == 1) {
+        return my_lm;
+    }
 
     nrounds_step1 = floor(log2((double)nprocs));
     max_power_two = (int)pow(2.0, (double)nrounds_step1);
@@ -518,21 +384,21 @@ void hca_synchronize_clocks(void)
 
                 // master
                 other_rank = my_rank + my_pow_2(i);
-                compute_rtt(my_rank, other_rank, n_pingpongs, &current_rtt);
+                compute_rtt(my_rank, other_rank, n_pingpongs, &current_rtt, comm);
 
 
                 // compute model through linear regression
-                hca_learn_model(my_rank, other_rank, parameters, current_rtt);
-#ifdef ENABLE_LOGP_SYNC
-                compute_and_set_intercept(NULL, other_rank, my_rank);
-#endif
+                hca_learn_model(my_rank, other_rank, parameters, current_rtt, comm);
+                if (merge_intercepts) {
+                    compute_and_set_intercept(NULL, other_rank, my_rank, comm);
+                }
 
                 // so I also need to receive some other models from my partner rank
                 // there should be 2^i models to receive
                 nb_lm_to_comm = my_pow_2(i);
 
                 if( nb_lm_to_comm > 0 ) {
-                    MPI_Recv(&tmp_linear_models[0], nb_lm_to_comm, mpi_lm_t, other_rank, 0, MPI_COMM_WORLD, &stat);
+                    MPI_Recv(&tmp_linear_models[0], nb_lm_to_comm, mpi_lm_t, other_rank, 0, comm, &stat);
 
                     linear_models[other_rank] = tmp_linear_models[0];
                     for(j=1; j<nb_lm_to_comm; j++) {
@@ -544,13 +410,13 @@ void hca_synchronize_clocks(void)
             else if( my_rank % running_power == my_pow_2(i) ) {
                 // client
                 other_rank = my_rank - my_pow_2(i);
-                compute_rtt(other_rank, my_rank, n_pingpongs, &current_rtt);
+                compute_rtt(other_rank, my_rank, n_pingpongs, &current_rtt, comm);
 
                 // compute model through linear regression
-                linear_models[my_rank] = hca_learn_model(other_rank, my_rank, parameters, current_rtt);
-#ifdef ENABLE_LOGP_SYNC
-                compute_and_set_intercept(&linear_models[my_rank], my_rank, other_rank);
-#endif
+                linear_models[my_rank] = hca_learn_model(other_rank, my_rank, parameters, current_rtt, comm);
+                if (merge_intercepts) {
+                    compute_and_set_intercept(&linear_models[my_rank], my_rank, other_rank, comm);
+                }
 
                 // I will need to send my models back to the master
                 // there should be 2^i models to send
@@ -558,15 +424,15 @@ void hca_synchronize_clocks(void)
                 nb_lm_to_comm = my_pow_2(i);
 
                 if( nb_lm_to_comm > 0 ) {
-                    MPI_Send(&linear_models[my_rank], nb_lm_to_comm, mpi_lm_t, other_rank, 0, MPI_COMM_WORLD);
+                    MPI_Send(&linear_models[my_rank], nb_lm_to_comm, mpi_lm_t, other_rank, 0, comm);
                 }
             }
         }
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(comm);
     }
 
 
-    MPI_Comm_group(MPI_COMM_WORLD, &orig_group);
+    MPI_Comm_group(comm, &orig_group);
     step_two_nb_ranks = nprocs - max_power_two + 1;
     step_two_group_ranks = (int*) calloc(step_two_nb_ranks, sizeof(int));
 
@@ -580,7 +446,7 @@ void hca_synchronize_clocks(void)
     MPI_Group_incl(orig_group, step_two_nb_ranks, step_two_group_ranks,
             &step_two_group);
 
-    MPI_Comm_create(MPI_COMM_WORLD, step_two_group, &step_two_comm);
+    MPI_Comm_create(comm, step_two_group, &step_two_comm);
 
     // now step 2
     // synchronize processes with ranks > 2^max_power_two
@@ -590,25 +456,25 @@ void hca_synchronize_clocks(void)
             if( my_rank + max_power_two < nprocs ) {
 
                 other_rank = my_rank + max_power_two;
-                compute_rtt(my_rank, other_rank, n_pingpongs, &current_rtt);
+                compute_rtt(my_rank, other_rank, n_pingpongs, &current_rtt, comm);
 
                 // compute model through linear regression
-                linear_models[other_rank] = hca_learn_model(my_rank, other_rank, parameters, current_rtt);
-#ifdef ENABLE_LOGP_SYNC
-                compute_and_set_intercept(NULL, other_rank, my_rank);
-#endif
+                linear_models[other_rank] = hca_learn_model(my_rank, other_rank, parameters, current_rtt, comm);
+                if (merge_intercepts) {
+                    compute_and_set_intercept(NULL, other_rank, my_rank, comm);
+                }
             }
 
         } else {
             other_rank = my_rank - max_power_two;
-            compute_rtt(other_rank, my_rank, n_pingpongs, &current_rtt);
+            compute_rtt(other_rank, my_rank, n_pingpongs, &current_rtt, comm);
 
             // compute model through linear regression
             linear_models[my_rank] = hca_learn_model(other_rank, my_rank,
-                    parameters, current_rtt);
-#ifdef ENABLE_LOGP_SYNC
-            compute_and_set_intercept(&linear_models[my_rank], my_rank, other_rank);
-#endif
+                    parameters, current_rtt, comm);
+            if (merge_intercepts) {
+                compute_and_set_intercept(&linear_models[my_rank], my_rank, other_rank, comm);
+            }
         }
 
 
@@ -616,7 +482,6 @@ void hca_synchronize_clocks(void)
             // 0 in sub comm is master rank
             MPI_Gather(&linear_models[my_rank], 1, mpi_lm_t,
                     &tmp_linear_models[0], 1, mpi_lm_t, 0, step_two_comm);
-            MPI_Comm_free(&step_two_comm);
         }
 
         if( my_rank == master_rank ) {
@@ -634,23 +499,354 @@ void hca_synchronize_clocks(void)
             }
         }
     }
+    if( step_two_comm != MPI_COMM_NULL ) {
+        MPI_Comm_free(&step_two_comm);
+    }
+    MPI_Group_free(&step_two_group);
+    MPI_Group_free(&orig_group);
 
-    MPI_Scatter(linear_models, 1, mpi_lm_t, &lm, 1, mpi_lm_t, master_rank, MPI_COMM_WORLD);
+    MPI_Scatter(linear_models, 1, mpi_lm_t, &my_lm, 1, mpi_lm_t, master_rank, comm);
 
-#ifndef ENABLE_LOGP_SYNC
-    compute_and_set_all_intercepts(&lm);
-#endif
-    MPI_Barrier(MPI_COMM_WORLD);
+    if (!merge_intercepts) {
+        compute_and_set_all_intercepts(&my_lm, comm);
+    }
+    MPI_Barrier(comm);
 
+    MPI_Type_free(&mpi_lm_t);
+    free(step_two_group_ranks);
     free(linear_models);
     free(tmp_linear_models);
-    free(rtts_s);
 
     if( my_rank == master_rank ) {
-        lm.slope = 0;
-        lm.intercept = 0;
+        my_lm.slope = 0;
+        my_lm.intercept = 0;
     }
 
+    return my_lm;
+}
+
+
+/*
+ * Two-level synchronization: the node leaders are synchronized with the root
+ * using leaders_topology and each process composes its model relative to its
+ * node leader with the model of the leader.
+ * The models relative to the node leaders are either learned on all nodes in
+ * parallel or, if inherit_node_model is set, the processes of a node are
+ * assumed to share the clock of their leader.
+ */
+static lm_t hca_learn_models_hierarchical(const reprompi_hca_topology_t leaders_topology,
+        const int inherit_node_model)
+{
+    MPI_Comm node_comm, leaders_comm;
+    lm_t local_lm, leader_lm;
+    double leader_timestamp;
+
+    reprompi_create_node_comms(&node_comm, &leaders_comm);
+
+    if (inherit_node_model) {
+        // same clock as the leader, only the adjusted times differ by the initial timestamps
+        leader_timestamp = initial_timestamp;
+        MPI_Bcast(&leader_timestamp, 1, MPI_DOUBLE, 0, node_comm);
+        local_lm.slope = 0;
+        local_lm.intercept = leader_timestamp - initial_timestamp;
+    } else {
+        local_lm = hca_learn_models_on_comm(node_comm, HCA_TOPOLOGY_BINOMIAL);
+    }
+
+    leader_lm.intercept = 0;
+    leader_lm.slope = 0;
+    if (leaders_comm != MPI_COMM_NULL) {
+        leader_lm = hca_learn_models_on_comm(leaders_comm, leaders_topology);
+    }
+    MPI_Bcast(&leader_lm, 2, MPI_DOUBLE, 0, node_comm);
+    reprompi_free_node_comms(&node_comm, &leaders_comm);
+
+    return merge_linear_models(leader_lm, local_lm);
+}
+
+
+static double hca_get_global_time(void)
+{
+    return hca_get_normalized_time(hca_get_adjusted_time());
+}
+
+
+static void hca_learn_clock_models(void)
+{
+    // the network may have changed since the last synchronization
+    reprompi_sync_pingpong_reset_mean_rtt();
+    fit_residual_max = 0;
+    fit_pred_err_max = -1;
+    n_exchanges_done = 0;
+    n_fitpoints_done = 0;
+    if (parameters.node_leader_sync) {
+        lm = hca_learn_models_hierarchical(
+                (parameters.topology == HCA_TOPOLOGY_HIERARCHICAL) ? HCA_TOPOLOGY_BINOMIAL : parameters.topology, 1);
+    } else if (parameters.topology == HCA_TOPOLOGY_HIERARCHICAL) {
+        lm = hca_learn_models_hierarchical(HCA_TOPOLOGY_BINOMIAL, 0);
+    } else {
+        lm = hca_learn_models_on_comm(MPI_COMM_WORLD, parameters.topology);
+    }
+
+    // the check uses the new models
+    if (parameters.node_offset_check) {
+        MPI_Comm node_comm, leaders_comm;
+
+        reprompi_create_node_comms(&node_comm, &leaders_comm);
+        reprompi_check_node_offsets(node_comm, parameters.output_file, hca_get_global_time);
+        reprompi_free_node_comms(&node_comm, &leaders_comm);
+    }
+}
+
+
+static void print_fit_quality(FILE* f, const double* max_errors, const long* sum_counts)
+{
+    fprintf(f, "#@hca_fit_residual_max_s=%.10f\n", max_errors[0]);
+    if (max_errors[1] >= 0) {
+        fprintf(f, "#@hca_fit_pred_err_max_s=%.10f\n", max_errors[1]);
+    }
+    if (parameters.offset_ci_sec > 0 && sum_counts[1] > 0) {
+        fprintf(f, "#@hca_exchanges_per_fitpoint=%.2f\n", (double)sum_counts[0] / sum_counts[1]);
+    }
+}
+
+
+/*
+ * Print the largest residual and prediction error of the pairwise fits and,
+ * in the adaptive mode, the mean number of exchanges per fit point.
+ * Nothing is printed with the default drift model and offset estimator.
+ */
+static void hca_print_fit_quality(void)
+{
+    int my_rank;
+    int master_rank = 0;
+    double local_errors[2], max_errors[2];
+    long local_counts[2], sum_counts[2] = { 0, 0 };
+    FILE* f;
+
+    if (parameters.drift_model == HCA_DRIFT_MODEL_LINEAR
+            && parameters.offset_estimator == HCA_OFFSET_ESTIMATOR_MEDIAN
+            && parameters.offset_ci_sec <= 0) {
+        return;
+    }
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    local_errors[0] = fit_residual_max;
+    local_errors[1] = fit_pred_err_max;
+    MPI_Reduce(local_errors, max_errors, 2, MPI_DOUBLE, MPI_MAX, master_rank, MPI_COMM_WORLD);
+
+    if (parameters.offset_ci_sec > 0) {
+        local_counts[0] = n_exchanges_done;
+        local_counts[1] = n_fitpoints_done;
+        MPI_Reduce(local_counts, sum_counts, 2, MPI_LONG, MPI_SUM, master_rank, MPI_COMM_WORLD);
+    }
+
+    if (my_rank == master_rank) {
+        print_fit_quality(stdout, max_errors, sum_counts);
+        if (parameters.output_file != NULL) {
+            f = fopen(parameters.output_file, "a");
+            print_fit_quality(f, max_errors, sum_counts);
+            fflush(f);
+            fclose(f);
+        }
+    }
+}
+
+
+/*
+ * Returns 1 if the model learned for a previous job (with --sync-model-cache)
+ * or loaded from the model file can be reused, i.e., if all processes are still
+ * within the tolerated offset to the root.
+ */
+static int hca_reuse_clock_models(void)
+{
+    double model[3];
+    int loaded = 0;
+
+    if (!model_available && parameters.model_file != NULL) {
+        if (reprompi_load_sync_model(parameters.model_file, model, 3)) {
+            lm.intercept = model[0];
+            lm.slope = model[1];
+            initial_timestamp = model[2];
+            model_available = 1;
+            loaded = 1;
+        }
+    }
+    if (!model_available || !(parameters.model_cache || loaded)) {
+        return 0;
+    }
+
+    if (reprompi_validate_sync_model(hca_get_global_time, parameters.n_exchanges, parameters.model_tolerance_sec)) {
+        return 1;
+    }
+    if (loaded) {
+        // the loaded model may refer to a different time base
+        initial_timestamp = get_time();
+    }
+    return 0;
+}
+
+
+void hca_synchronize_clocks(void)
+{
+    double model[3];
+
+    // a non-linear correction only holds for the job it was fitted in
+    drift_nonlinear = 0;
+
+    if (!hca_reuse_clock_models()) {
+        hca_learn_clock_models();
+        hca_print_fit_quality();
+        model_available = 1;
+
+        if (parameters.model_file != NULL) {
+            model[0] = lm.intercept;
+            model[1] = lm.slope;
+            model[2] = initial_timestamp;
+            reprompi_save_sync_model(parameters.model_file, model, 3);
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // the learned model has no offset at the end of the synchronization
+    learned_lm = lm;
+    if (max_update_points == 0) {
+        max_update_points = 16;
+        update_x = (double*) malloc(max_update_points * sizeof(double));
+        update_y = (double*) malloc(max_update_points * sizeof(double));
+    }
+    update_x[0] = hca_get_adjusted_time();
+    update_y[0] = 0;
+    n_update_points = 1;
+
+    reprompi_sync_check_begin(parameters.sync_check_ranks, parameters.output_file, hca_get_adjusted_time,
+            hca_get_normalized_time);
+}
+
+
+/*
+ * Incremental model update between two windows: each process measures the
+ * remaining offset of its global time to the root, converts it into the
+ * offset of the originally learned model and refits the correction of that
+ * model over all update points, so that noisy single measurements are
+ * blended with the previous ones instead of replacing the model.
+ * The correction uses the drift model given by --hca-drift-model, so that a
+ * drift that bends over a long job can be followed by a non-linear correction.
+ */
+static void hca_update_clock_model(void)
+{
+    int my_rank;
+    int master_rank = 0;
+    double offset, now, learned_offset;
+    double corr_slope, corr_intercept;
+    reprompi_hca_drift_fit_t fit;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    // a few ping-pongs per pair along a binomial tree keep the update short,
+    // the noise of single updates is smoothed by the fit over all update points
+    offset = reprompi_measure_offset_to_root_tree(hca_get_global_time,
+            (int)repro_min(parameters.n_exchanges, HCA_RESYNC_MAX_PINGPONGS), NULL);
+
+    now = hca_get_adjusted_time();
+    if (my_rank != master_rank) {
+        // offset of the learned model = measured offset + correction currently applied
+        learned_offset = offset + (now * (lm.slope - learned_lm.slope) + lm.intercept - learned_lm.intercept);
+        if (drift_nonlinear) {
+            learned_offset += reprompi_hca_drift_eval_nonlinear(&drift_fit, now);
+        }
+
+        if (n_update_points == max_update_points) {
+            max_update_points *= 2;
+            update_x = (double*) realloc(update_x, max_update_points * sizeof(double));
+            update_y = (double*) realloc(update_y, max_update_points * sizeof(double));
+        }
+        update_x[n_update_points] = now;
+        update_y[n_update_points] = learned_offset;
+        n_update_points++;
+
+        // too few points for a non-linear model: start with a line
+        if (reprompi_hca_drift_fit(parameters.drift_model, 0, update_x, update_y, n_update_points, &fit) == 0
+                || reprompi_hca_drift_fit(HCA_DRIFT_MODEL_LINEAR, 0, update_x, update_y, n_update_points, &fit) == 0) {
+            reprompi_hca_drift_get_line(&fit, &corr_intercept, &corr_slope);
+
+            lm.slope = learned_lm.slope + corr_slope;
+            lm.intercept = learned_lm.intercept + corr_intercept;
+            drift_fit = fit;
+            drift_nonlinear = reprompi_hca_drift_is_nonlinear(&fit);
+        }
+    }
+}
+
+
+static void print_drift_model_comparison(FILE* f, const double* max_errors)
+{
+    int i;
+
+    for (i = 0; i < HCA_DRIFT_MODEL_AUTO; i++) {
+        if (max_errors[2 * i] >= 0) {
+            fprintf(f, "#@hca_drift_%s_residual_max_s=%.10f\n",
+                    reprompi_get_hca_drift_model_name((reprompi_hca_drift_model_t)i), max_errors[2 * i]);
+        }
+        if (max_errors[2 * i + 1] >= 0) {
+            fprintf(f, "#@hca_drift_%s_pred_err_max_s=%.10f\n",
+                    reprompi_get_hca_drift_model_name((reprompi_hca_drift_model_t)i), max_errors[2 * i + 1]);
+        }
+    }
+}
+
+
+/*
+ * Compare the drift models on the update points of the job: print the largest
+ * residual and leave-one-out prediction error of each model over all processes.
+ */
+static void hca_print_drift_model_comparison(void)
+{
+    int my_rank;
+    int master_rank = 0;
+    double local_errors[2 * HCA_DRIFT_MODEL_AUTO], max_errors[2 * HCA_DRIFT_MODEL_AUTO];
+    reprompi_hca_drift_model_t type;
+    reprompi_hca_drift_fit_t fit;
+    FILE* f;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    for (type = HCA_DRIFT_MODEL_LINEAR; type < HCA_DRIFT_MODEL_AUTO; type++) {
+        local_errors[2 * type] = local_errors[2 * type + 1] = -1;
+        if (my_rank != master_rank
+                && reprompi_hca_drift_fit(type, 0, update_x, update_y, n_update_points, &fit) == 0) {
+            local_errors[2 * type] = fit.residual_rms;
+            local_errors[2 * type + 1] = fit.prediction_error;
+        }
+    }
+    MPI_Reduce(local_errors, max_errors, 2 * HCA_DRIFT_MODEL_AUTO, MPI_DOUBLE, MPI_MAX,
+            master_rank, MPI_COMM_WORLD);
+
+    if (my_rank == master_rank) {
+        print_drift_model_comparison(stdout, max_errors);
+        if (parameters.output_file != NULL) {
+            f = fopen(parameters.output_file, "a");
+            print_drift_model_comparison(f, max_errors);
+            fflush(f);
+            fclose(f);
+        }
+    }
+}
+
+
+/* the next window starts wait_time_sec after the current time of the root */
+static void hca_restart_windows(void)
+{
+    int my_rank;
+    int master_rank = 0;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    if (my_rank == master_rank) {
+        start_sync = hca_get_normalized_time(hca_get_adjusted_time()) + parameters.wait_time_sec;
+    }
+    MPI_Bcast(&start_sync, 1, MPI_DOUBLE, master_rank, MPI_COMM_WORLD);
 }
 
 
@@ -660,44 +856,57 @@ void hca_init_synchronization(void) {
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
 
+    // the windows may be restarted several times for the same module (e.g., time-budgeted runs)
+    memset(invalid, 0, parameters.n_rep * sizeof(int));
+    memset(start_errors, 0, parameters.n_rep * sizeof(double));
+    memset(window_slack, 0, parameters.n_rep * sizeof(double));
+
     repetition_counter = 0;
     if( my_rank == master_rank ) {
         start_sync = hca_get_adjusted_time() + parameters.wait_time_sec;
     }
     MPI_Bcast(&start_sync, 1, MPI_DOUBLE, master_rank, MPI_COMM_WORLD);
-
+    last_resync_start = start_sync;
 }
 
 void hca_start_synchronization(void)
 {
-    int is_first = 1;
     double global_time;
 
-    while(1) {
-        global_time = hca_get_normalized_time(hca_get_adjusted_time());
-
-        if( global_time >= start_sync ) {
-            if( is_first == 1 ) {
-                invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
-            }
-            break;
-        }
-        is_first = 0;
+    if( !reprompi_wait_until(start_sync, hca_get_global_time, parameters.hybrid_wait_spin_sec, &global_time) ) {
+        invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
     }
+    start_errors[repetition_counter] = global_time - start_sync;
 }
 
 
 void hca_stop_synchronization(void)
 {
     double global_time;
+    int restart_windows;
     global_time = hca_get_normalized_time(hca_get_adjusted_time());
 
     if( global_time > start_sync + parameters.window_size_sec ) {
         invalid[repetition_counter] |= FLAG_SYNC_WIN_EXPIRED;
     }
+    window_slack[repetition_counter] = start_sync + parameters.window_size_sec - global_time;
+
+    restart_windows = reprompi_adaptive_window_update(&adaptive_window, global_time - start_sync,
+            invalid[repetition_counter], &(parameters.window_size_sec));
 
     start_sync += parameters.window_size_sec;
     repetition_counter++;
+
+    // the window starts are the same on all processes, so that they agree on when to update
+    if (repetition_counter < parameters.n_rep
+            && ((parameters.resync_windows > 0 && repetition_counter % parameters.resync_windows == 0)
+                || (parameters.resync_time_sec > 0 && start_sync - last_resync_start >= parameters.resync_time_sec))) {
+        hca_update_clock_model();
+        hca_restart_windows();
+        last_resync_start = start_sync;
+    } else if (restart_windows) {
+        hca_restart_windows();
+    }
 }
 
 
@@ -708,9 +917,35 @@ int* hca_get_local_sync_errorcodes(void)
 }
 
 
+double* hca_get_local_start_errors(void)
+{
+    return start_errors;
+}
+
+
+double* hca_get_local_window_slack(void)
+{
+    return window_slack;
+}
+
+
 void hca_cleanup_synchronization_module(void)
 {
+    // the check uses the final clock models, including the updates made during the job
+    reprompi_sync_check_end();
+    if ((parameters.resync_windows > 0 || parameters.resync_time_sec > 0) && max_update_points > 0) {
+        hca_print_drift_model_comparison();
+    }
+    free(update_x);
+    free(update_y);
+    update_x = update_y = NULL;
+    max_update_points = 0;
     free(invalid);
+    free(start_errors);
+    free(window_slack);
+    reprompi_print_adaptive_window_sizes(&adaptive_window, parameters.output_file);
+    reprompi_adaptive_window_cleanup(&adaptive_window);
+    reprompi_sync_pingpong_cleanup();
 }
 
 
@@ -721,11 +956,33 @@ void hca_print_sync_parameters(FILE* f)
     fprintf(f, "#@fitpoints=%d\n", parameters.n_fitpoints);
     fprintf(f, "#@exchanges=%d\n", parameters.n_exchanges);
     fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
-#ifdef ENABLE_LOGP_SYNC
-    fprintf(f, "#@hcasynctype=logp\n");
-#else
-    fprintf(f, "#@hcasynctype=linear\n");
-#endif
+    reprompi_print_wait_info(f, parameters.hybrid_wait_spin_sec);
+    hca_print_sync_type(f);
+    if (parameters.resync_windows > 0) {
+        fprintf(f, "#@hca_resync_windows=%ld\n", parameters.resync_windows);
+    }
+    if (parameters.resync_time_sec > 0) {
+        fprintf(f, "#@hca_resync_time_s=%.10f\n", parameters.resync_time_sec);
+    }
+    if (parameters.drift_model != HCA_DRIFT_MODEL_LINEAR) {
+        fprintf(f, "#@hca_drift_model=%s\n", reprompi_get_hca_drift_model_name(parameters.drift_model));
+    }
+    if (parameters.offset_estimator != HCA_OFFSET_ESTIMATOR_MEDIAN) {
+        fprintf(f, "#@hca_offset_estimator=%s\n", reprompi_get_hca_offset_estimator_name(parameters.offset_estimator));
+    }
+    if (parameters.offset_ci_sec > 0) {
+        fprintf(f, "#@hca_offset_ci_s=%.10f\n", parameters.offset_ci_sec);
+    }
+    reprompi_print_node_sync_info(f, parameters.node_leader_sync, parameters.node_offset_check);
+    reprompi_print_sync_model_cache_info(f, parameters.model_cache, parameters.model_tolerance_sec,
+            parameters.model_file);
+    reprompi_print_adaptive_window_info(f, &adaptive_window);
+    reprompi_print_sync_check_info(f, parameters.sync_check_ranks);
+}
+
+void hca_print_sync_type(FILE* f)
+{
+    fprintf(f, "#@hcasynctype=%s\n", reprompi_get_hca_topology_name(parameters.topology));
 }
 
 
@@ -25,6 +25,7 @@
 #define HCA_SYNC_H_
 
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/time_measurement.h"
 
 typedef struct {
     long n_rep; /* --repetitions */
@@ -34,6 +35,24 @@ typedef struct {
     int n_exchanges; /* --exchanges */
 
     double wait_time_sec; /* --wait-time */
+    double hybrid_wait_spin_sec; /* --hybrid-wait */
+    int sync_check_ranks; /* --sync-check */
+    char* output_file; /* --output-file */
+
+    reprompi_hca_topology_t topology; /* --hca-topology */
+
+    int node_leader_sync; /* --node-leader-sync */
+    int node_offset_check; /* --node-offset-check */
+
+    long resync_windows; /* --hca-resync-windows */
+    double resync_time_sec; /* --hca-resync-time */
+    reprompi_hca_drift_model_t drift_model; /* --hca-drift-model */
+    reprompi_hca_offset_estimator_t offset_estimator; /* --hca-offset-estimator */
+    double offset_ci_sec; /* --hca-offset-ci */
+
+    int model_cache; /* --sync-model-cache */
+    double model_tolerance_sec; /* --sync-model-tolerance */
+    char* model_file; /* --sync-model-file */
 } reprompi_hca_params_t;
 
 void hca_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
@@ -44,11 +63,15 @@ void hca_stop_synchronization(void);
 void hca_cleanup_synchronization_module(void);
 
 int* hca_get_local_sync_errorcodes(void);
+double* hca_get_local_start_errors(void);
+double* hca_get_local_window_slack(void);
 
 double hca_get_normalized_time(double local_time);
 double hca_get_adjusted_time(void);
+double hca_ticks_to_adjusted_time(const reprompi_ticks_t ticks);
 
 void hca_print_sync_parameters(FILE* f);
+void hca_print_sync_type(FILE* f);
 
 int my_pow_2(int exp);
 
@@ -24,6 +24,7 @@
 #include "mpi.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include <assert.h>
 #include <gsl/gsl_statistics.h>
@@ -32,6 +33,12 @@
 
 #include "reprompi_bench/sync/time_measurement.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/node_sync.h"
+#include "reprompi_bench/sync/sync_model_cache.h"
+#include "reprompi_bench/sync/adaptive_window.h"
+#include "reprompi_bench/sync/sync_pingpong.h"
+#include "reprompi_bench/sync/sync_wait.h"
+#include "reprompi_bench/sync/sync_check.h"
 #include "jk_parse_options.h"
 #include "jk_sync.h"
 
@@ -39,7 +46,10 @@ const int WARMUP_ROUNDS = 5;
 
 static double start_sync = 0; /* current window start timestamp (global time) */
 static int* invalid;
+static double* start_errors;        /* start_errors[i] is the time between the start of window i and the end of the wait (global time) */
+static double* window_slack;        /* window_slack[i] is the time left in window i after the measurement, negative if it expired (global time) */
 static int repetition_counter = 0; /* current repetition index */
+static reprompi_adaptive_window_t adaptive_window;
 
 // options specified from the command line
 static reprompi_jk_options_t parameters;
@@ -49,124 +59,45 @@ static double my_rtt;
 
 //linear model
 double slope, intercept;
+static int model_available = 0; /* slope and intercept hold a model learned or loaded before */
 
 void estimate_rtt(int master_rank, int other_rank, const int n_pingpongs,
-        double *rtt) {
-    int my_rank, np;
-    MPI_Status stat;
-    int i;
-    double tmp;
-    double *rtts = NULL;
-
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
-
-    if (my_rank == master_rank) {
-        double tstart, tremote;
-
-        /* warm up */
-        for (i = 0; i < WARMUP_ROUNDS; i++) {
-            tmp = get_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD);
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD, &stat);
-        }
-
-        rtts = (double*) malloc(n_pingpongs * sizeof(double));
-
-        for (i = 0; i < n_pingpongs; i++) {
-            tstart = get_time();
-            MPI_Send(&tstart, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD);
-            MPI_Recv(&tremote, 1, MPI_DOUBLE, other_rank, 0, MPI_COMM_WORLD,
-                    &stat);
-            rtts[i] = get_time() - tstart;
-        }
-
-    } else if (my_rank == other_rank) {
-        double tlocal = 0, troot;
-
-        /* warm up */
-        for (i = 0; i < WARMUP_ROUNDS; i++) {
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD,
-                    &stat);
-            tmp = get_time();
-            MPI_Send(&tmp, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD);
-        }
-
-        for (i = 0; i < n_pingpongs; i++) {
-            MPI_Recv(&troot, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD,
-                    &stat);
-            tlocal = get_time();
-            MPI_Send(&tlocal, 1, MPI_DOUBLE, master_rank, 0, MPI_COMM_WORLD);
-        }
-    }
-
-    if (my_rank == master_rank) {
-        double mean;
-        double upperq;
-        double cutoff_val;
-        double *rtts2;
-        int n_datapoints;
-
-        gsl_sort(rtts, 1, n_pingpongs);
-
-        upperq = gsl_stats_quantile_from_sorted_data(rtts, 1, n_pingpongs,
-                0.75);
-        cutoff_val = 1.5 * upperq;
-
-        //    printf("cutoff=%.20f\n", cutoff_val);
-        rtts2 = (double*) calloc(n_pingpongs, sizeof(double));
-        n_datapoints = 0;
-        for (i = 0; i < n_pingpongs; i++) {
-            if (rtts[i] <= cutoff_val) {
-                rtts2[i] = rtts[i];
-                n_datapoints = i + 1;
-            } else {
-                break;
-            }
-        }
-        //    printf("n_datapoints=%d\n", n_datapoints);
-
-        //mean = gsl_stats_mean(rtts, 1, n_pingpongs);
-        mean = gsl_stats_mean(rtts2, 1, n_datapoints);
-        //    printf("mean with outlier detection: %.20f\n", gsl_stats_mean(rtts2, 1, n_datapoints));
-        *rtt = mean;
-
-        free(rtts);
-        free(rtts2);
-    }
+        double *rtt, MPI_Comm comm) {
+    *rtt = reprompi_sync_pingpong_mean_rtt(master_rank, other_rank, n_pingpongs, WARMUP_ROUNDS, comm, get_time);
 }
 
-void warmup(int root_rank) {
+void warmup(int root_rank, MPI_Comm comm) {
     int my_rank, np;
     MPI_Status status;
     int i, p;
     double tmp;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
 
     if (root_rank == my_rank) {
         for (i = 0; i < WARMUP_ROUNDS; i++) {
             for (p = 0; p < np; p++) {
                 if (p != root_rank) {
-                    MPI_Send(&tmp, 1, MPI_DOUBLE, p, 0, MPI_COMM_WORLD);
-                    MPI_Recv(&tmp, 1, MPI_DOUBLE, p, 0, MPI_COMM_WORLD,
+                    MPI_Send(&tmp, 1, MPI_DOUBLE, p, 0, comm);
+                    MPI_Recv(&tmp, 1, MPI_DOUBLE, p, 0, comm,
                             &status);
                 }
             }
         }
     } else {
         for (i = 0; i < WARMUP_ROUNDS; i++) {
-            MPI_Recv(&tmp, 1, MPI_DOUBLE, root_rank, 0, MPI_COMM_WORLD,
+            MPI_Recv(&tmp, 1, MPI_DOUBLE, root_rank, 0, comm,
                     &status);
-            MPI_Send(&tmp, 1, MPI_DOUBLE, root_rank, 0, MPI_COMM_WORLD);
+            MPI_Send(&tmp, 1, MPI_DOUBLE, root_rank, 0, comm);
         }
     }
 
 }
 
 void learn_clock(const int root_rank, double *intercept, double *slope,
-        const long n_fitpoints, const long n_exchanges, const double my_rtt) {
+        const long n_fitpoints, const long n_exchanges, const double my_rtt,
+        MPI_Comm comm) {
     int i, j, p;
     int my_rank, np;
     MPI_Status status;
@@ -176,8 +107,8 @@ void learn_clock(const int root_rank, double *intercept, double *slope,
     //  ts.tv_sec  = 0;
     //  ts.tv_nsec = wait_nsec;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
 
     //  printf("rtt of %d : %.20f\n", my_rank, my_rtt);
 
@@ -193,10 +124,10 @@ void learn_clock(const int root_rank, double *intercept, double *slope,
             for (p = 0; p < np; p++) {
                 if (p != root_rank) {
                     for (i = 0; i < n_exchanges; i++) {
-                        MPI_Recv(&tremote, 1, MPI_DOUBLE, p, 0, MPI_COMM_WORLD,
+                        MPI_Recv(&tremote, 1, MPI_DOUBLE, p, 0, comm,
                                 &status);
                         tlocal = get_time();
-                        MPI_Ssend(&tlocal, 1, MPI_DOUBLE, p, 0, MPI_COMM_WORLD);
+                        MPI_Ssend(&tlocal, 1, MPI_DOUBLE, p, 0, comm);
                     }
                 }
             }
@@ -223,9 +154,9 @@ void learn_clock(const int root_rank, double *intercept, double *slope,
 
             for (i = 0; i < n_exchanges; i++) {
                 dummy = get_time();
-                MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, MPI_COMM_WORLD);
+                MPI_Ssend(&dummy, 1, MPI_DOUBLE, root_rank, 0, comm);
                 MPI_Recv(&master_time, 1, MPI_DOUBLE, root_rank, 0,
-                        MPI_COMM_WORLD, &status);
+                        comm, &status);
                 local_time[i] = get_time();
                 time_var[i] = local_time[i] - master_time - my_rtt / 2.0;
                 time_var2[i] = time_var[i];
@@ -277,48 +208,137 @@ void jk_init_synchronization_module(const reprompib_sync_options_t parsed_opts,
     parameters.n_exchanges = parsed_opts.n_exchanges;
     parameters.n_fitpoints = parsed_opts.n_fitpoints;
     parameters.wait_time_sec = parsed_opts.wait_time_sec;
+    parameters.hybrid_wait_spin_sec = parsed_opts.hybrid_wait_spin_sec;
+    parameters.sync_check_ranks = parsed_opts.sync_check_ranks;
+    parameters.output_file = parsed_opts.output_file;
     parameters.window_size_sec = parsed_opts.window_size_sec;
+    parameters.node_leader_sync = parsed_opts.node_leader_sync;
+    parameters.node_offset_check = parsed_opts.node_offset_check;
+    parameters.model_cache = parsed_opts.sync_model_cache;
+    parameters.model_tolerance_sec = parsed_opts.sync_model_tolerance_sec;
+    parameters.model_file = parsed_opts.sync_model_file;
     parameters.n_rep = nrep;
 
     invalid = (int*) calloc(parameters.n_rep, sizeof(int));
     for (i = 0; i < parameters.n_rep; i++) {
         invalid[i] = 0;
     }
+    start_errors = (double*) calloc(parameters.n_rep, sizeof(double));
+    window_slack = (double*) calloc(parameters.n_rep, sizeof(double));
     repetition_counter = 0;
-
+    reprompi_adaptive_window_init(&adaptive_window, &parsed_opts);
 }
 
-void jk_sync_clocks(void) {
+static void jk_sync_clocks_on_comm(MPI_Comm comm) {
     int p;
     int master_rank;
-    double *rtts_s;
+    double rtt;
     int n_pingpongs = 1000;
     int my_rank, np;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
 
     master_rank = 0;
+    my_rtt = 0.0;
 
-    rtts_s = (double*) malloc(n_pingpongs * sizeof(double));
-    rtts_s[master_rank] = 0.0;
-
-    warmup(master_rank);
+    warmup(master_rank, comm);
 
+    // the RTT is known on both sides of each pair
     for (p = 0; p < np; p++) {
         if (p != master_rank) {
-            estimate_rtt(master_rank, p, n_pingpongs, &rtts_s[p]);
+            estimate_rtt(master_rank, p, n_pingpongs, &rtt, comm);
+            if (my_rank == p) {
+                my_rtt = rtt;
+            }
         }
     }
 
-    MPI_Scatter(rtts_s, 1, MPI_DOUBLE, &my_rtt, 1, MPI_DOUBLE, master_rank,
-            MPI_COMM_WORLD);
-    free(rtts_s);
-
     learn_clock(master_rank, &intercept, &slope, parameters.n_fitpoints,
-            parameters.n_exchanges, my_rtt);
+            parameters.n_exchanges, my_rtt, comm);
+
+    MPI_Barrier(comm);
+}
+
+static double jk_get_global_time(void) {
+    return jk_get_normalized_time(get_time());
+}
+
 
+static void jk_learn_clock_models(void) {
+    MPI_Comm node_comm, leaders_comm;
+    double model[2];
+
+    // the network may have changed since the last synchronization
+    reprompi_sync_pingpong_reset_mean_rtt();
+    if (!parameters.node_leader_sync && !parameters.node_offset_check) {
+        jk_sync_clocks_on_comm(MPI_COMM_WORLD);
+        return;
+    }
+
+    reprompi_create_node_comms(&node_comm, &leaders_comm);
+    if (parameters.node_leader_sync) {
+        // only the leaders learn a model, the other processes use the model of their leader
+        if (leaders_comm != MPI_COMM_NULL) {
+            jk_sync_clocks_on_comm(leaders_comm);
+        }
+        model[0] = intercept;
+        model[1] = slope;
+        MPI_Bcast(model, 2, MPI_DOUBLE, 0, node_comm);
+        intercept = model[0];
+        slope = model[1];
+    } else {
+        jk_sync_clocks_on_comm(MPI_COMM_WORLD);
+    }
+
+    if (parameters.node_offset_check) {
+        reprompi_check_node_offsets(node_comm, parameters.output_file, jk_get_global_time);
+    }
+    reprompi_free_node_comms(&node_comm, &leaders_comm);
+}
+
+
+/*
+ * Returns 1 if the model learned for a previous job (with --sync-model-cache)
+ * or loaded from the model file can be reused, i.e., if all processes are still
+ * within the tolerated offset to the root.
+ */
+static int jk_reuse_clock_models(void) {
+    double model[2];
+    int loaded = 0;
+
+    if (!model_available && parameters.model_file != NULL) {
+        if (reprompi_load_sync_model(parameters.model_file, model, 2)) {
+            intercept = model[0];
+            slope = model[1];
+            model_available = 1;
+            loaded = 1;
+        }
+    }
+    if (!model_available || !(parameters.model_cache || loaded)) {
+        return 0;
+    }
+
+    return reprompi_validate_sync_model(jk_get_global_time, parameters.n_exchanges, parameters.model_tolerance_sec);
+}
+
+
+void jk_sync_clocks(void) {
+    double model[2];
+
+    if (!jk_reuse_clock_models()) {
+        jk_learn_clock_models();
+        model_available = 1;
+
+        if (parameters.model_file != NULL) {
+            model[0] = intercept;
+            model[1] = slope;
+            reprompi_save_sync_model(parameters.model_file, model, 2);
+        }
+    }
     MPI_Barrier(MPI_COMM_WORLD);
+
+    reprompi_sync_check_begin(parameters.sync_check_ranks, parameters.output_file, get_time, jk_get_normalized_time);
 }
 
 
@@ -328,6 +348,11 @@ void jk_init_synchronization(void) {
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
 
+    // the windows may be restarted several times for the same module (e.g., time-budgeted runs)
+    memset(invalid, 0, parameters.n_rep * sizeof(int));
+    memset(start_errors, 0, parameters.n_rep * sizeof(double));
+    memset(window_slack, 0, parameters.n_rep * sizeof(double));
+
     repetition_counter = 0;
     if (my_rank == master_rank) {
         start_sync = get_time() + parameters.wait_time_sec;
@@ -337,31 +362,37 @@ void jk_init_synchronization(void) {
 
 
 void jk_start_synchronization(void) {
-    int is_first = 1;
     double global_time;
 
-    while (1) {
-        global_time = jk_get_normalized_time(get_time());
-
-        if (global_time >= start_sync) {
-            if (is_first == 1) {
-                invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
-            }
-            break;
-        }
-        is_first = 0;
+    if (!reprompi_wait_until(start_sync, jk_get_global_time, parameters.hybrid_wait_spin_sec, &global_time)) {
+        invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
     }
+    start_errors[repetition_counter] = global_time - start_sync;
 }
 
 void jk_stop_synchronization(void) {
     double global_time;
+    int my_rank;
+    int master_rank = 0;
+
     global_time = jk_get_normalized_time(get_time());
 
     if (global_time > start_sync + parameters.window_size_sec) {
         invalid[repetition_counter] |= FLAG_SYNC_WIN_EXPIRED;
     }
-
-    start_sync += parameters.window_size_sec;
+    window_slack[repetition_counter] = start_sync + parameters.window_size_sec - global_time;
+
+    if (reprompi_adaptive_window_update(&adaptive_window, global_time - start_sync,
+            invalid[repetition_counter], &(parameters.window_size_sec))) {
+        // the next window starts wait_time_sec after the current time of the root
+        MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+        if (my_rank == master_rank) {
+            start_sync = jk_get_normalized_time(get_time()) + parameters.wait_time_sec;
+        }
+        MPI_Bcast(&start_sync, 1, MPI_DOUBLE, master_rank, MPI_COMM_WORLD);
+    } else {
+        start_sync += parameters.window_size_sec;
+    }
     repetition_counter++;
 }
 
@@ -369,12 +400,26 @@ int* jk_get_local_sync_errorcodes(void) {
     return invalid;
 }
 
+double* jk_get_local_start_errors(void) {
+    return start_errors;
+}
+
+double* jk_get_local_window_slack(void) {
+    return window_slack;
+}
+
 double jk_get_timediff_to_root(double local_time) {
     return local_time - jk_get_normalized_time(local_time);
 }
 
 void jk_cleanup_synchronization_module(void) {
+    reprompi_sync_check_end();
     free(invalid);
+    free(start_errors);
+    free(window_slack);
+    reprompi_print_adaptive_window_sizes(&adaptive_window, parameters.output_file);
+    reprompi_adaptive_window_cleanup(&adaptive_window);
+    reprompi_sync_pingpong_cleanup();
 }
 
 void jk_print_sync_parameters(FILE* f) {
@@ -383,5 +428,11 @@ void jk_print_sync_parameters(FILE* f) {
     fprintf(f, "#@fitpoints=%d\n", parameters.n_fitpoints);
     fprintf(f, "#@exchanges=%d\n", parameters.n_exchanges);
     fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
+    reprompi_print_wait_info(f, parameters.hybrid_wait_spin_sec);
+    reprompi_print_node_sync_info(f, parameters.node_leader_sync, parameters.node_offset_check);
+    reprompi_print_sync_model_cache_info(f, parameters.model_cache, parameters.model_tolerance_sec,
+            parameters.model_file);
+    reprompi_print_adaptive_window_info(f, &adaptive_window);
+    reprompi_print_sync_check_info(f, parameters.sync_check_ranks);
 }
 
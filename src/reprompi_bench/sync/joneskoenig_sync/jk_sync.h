@@ -34,6 +34,16 @@ typedef struct {
     int n_exchanges; /* --exchanges */
 
     double wait_time_sec; /* --wait-time */
+    double hybrid_wait_spin_sec; /* --hybrid-wait */
+    int sync_check_ranks; /* --sync-check */
+    char* output_file; /* --output-file */
+
+    int node_leader_sync; /* --node-leader-sync */
+    int node_offset_check; /* --node-offset-check */
+
+    int model_cache; /* --sync-model-cache */
+    double model_tolerance_sec; /* --sync-model-tolerance */
+    char* model_file; /* --sync-model-file */
 } reprompi_jk_options_t;
 
 void jk_init_synchronization_module(const reprompib_sync_options_t parsed_opts, const long nrep);
@@ -44,6 +54,8 @@ void jk_stop_synchronization(void);
 void jk_cleanup_synchronization_module(void);
 
 int* jk_get_local_sync_errorcodes(void);
+double* jk_get_local_start_errors(void);
+double* jk_get_local_window_slack(void);
 
 double jk_get_normalized_time(double local_time);
 
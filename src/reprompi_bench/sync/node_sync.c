@@ -0,0 +1,97 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "mpi.h"
+
+#include "sync_pingpong.h"
+#include "node_sync.h"
+
+static const int NODE_OFFSET_CHECK_PINGPONGS = 20;
+
+
+void reprompi_create_node_comms(MPI_Comm* node_comm, MPI_Comm* leaders_comm) {
+    int my_rank, node_rank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    // ordering by global rank guarantees that rank 0 leads its node and the leaders
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL, node_comm);
+    MPI_Comm_rank(*node_comm, &node_rank);
+    MPI_Comm_split(MPI_COMM_WORLD, (node_rank == 0) ? 0 : MPI_UNDEFINED, my_rank, leaders_comm);
+}
+
+
+void reprompi_free_node_comms(MPI_Comm* node_comm, MPI_Comm* leaders_comm) {
+    if (*leaders_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(leaders_comm);
+    }
+    MPI_Comm_free(node_comm);
+}
+
+
+void reprompi_check_node_offsets(MPI_Comm node_comm, const char* output_file, double (*get_global_time)(void)) {
+    int node_rank, node_size;
+    int p;
+    double offset = 0;
+    double max_node_offset = 0;
+    int my_rank;
+    FILE* f;
+
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_size(node_comm, &node_size);
+
+    for (p = 1; p < node_size; p++) {
+        if (node_rank == 0 || node_rank == p) {
+            offset = reprompi_sync_pingpong_min_rtt_offset(p, 0, NODE_OFFSET_CHECK_PINGPONGS, node_comm,
+                    get_global_time, NULL);
+        }
+    }
+
+    offset = fabs(offset);
+    MPI_Reduce(&offset, &max_node_offset, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // the check is repeated for every clock synchronization, so the result is reported right away
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == 0) {
+        printf("#@node_offset_max_s=%.10f\n", max_node_offset);
+        if (output_file != NULL) {
+            f = fopen(output_file, "a");
+            fprintf(f, "#@node_offset_max_s=%.10f\n", max_node_offset);
+            fflush(f);
+            fclose(f);
+        }
+    }
+}
+
+
+void reprompi_print_node_sync_info(FILE* f, const int node_leader_sync, const int node_offset_check) {
+    if (node_leader_sync) {
+        fprintf(f, "#@node_leader_sync=1\n");
+    }
+    if (node_offset_check) {
+        fprintf(f, "#@node_offset_check=1\n");
+    }
+}
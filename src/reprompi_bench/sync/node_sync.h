@@ -0,0 +1,50 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_NODE_SYNC_H_
+#define REPROMPI_NODE_SYNC_H_
+
+#include <stdio.h>
+#include "mpi.h"
+
+/*
+ * Split MPI_COMM_WORLD into one communicator per node and one communicator
+ * containing the node leaders (MPI_COMM_NULL on all other processes).
+ * Global rank 0 is rank 0 in both its node communicator and the leaders communicator.
+ */
+void reprompi_create_node_comms(MPI_Comm* node_comm, MPI_Comm* leaders_comm);
+void reprompi_free_node_comms(MPI_Comm* node_comm, MPI_Comm* leaders_comm);
+
+/*
+ * Measure the offset between the global time of each process and the global
+ * time of its node leader with a few ping-pongs (all nodes in parallel), i.e.,
+ * the error left by the clock models; get_global_time returns the global time
+ * of the synchronization method. The largest absolute offset found
+ * across all nodes is printed by the root process and, if output_file is
+ * not NULL, appended to output_file.
+ */
+void reprompi_check_node_offsets(MPI_Comm node_comm, const char* output_file, double (*get_global_time)(void));
+
+void reprompi_print_node_sync_info(FILE* f, const int node_leader_sync, const int node_offset_check);
+
+#endif /* REPROMPI_NODE_SYNC_H_ */
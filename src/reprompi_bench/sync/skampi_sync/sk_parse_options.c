@@ -32,6 +32,7 @@
 
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/time_measurement.h"
 #include "sk_parse_options.h"
 
 void sk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
@@ -62,6 +63,42 @@ void sk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
         case REPROMPI_ARGS_WINSYNC_WAITTIME: /* wait time before starting the first measurement  (in usec) */
             opts_p->wait_time_sec = atof(optarg) * 1e-6;
             break;
+
+        case REPROMPI_ARGS_WINSYNC_HYBRID_WAIT: /* sleep until this long (in usec) before the window start, then spin */
+            opts_p->hybrid_wait_spin_sec = atof(optarg) * 1e-6;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_SYNC_CHECK: /* number of ranks whose global clock is validated after each job */
+            opts_p->sync_check_ranks = atoi(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_NODE_LEADER_SYNC: /* only node leaders synchronize with the root */
+            opts_p->node_leader_sync = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_NODE_OFFSET_CHECK: /* measure the clock offsets within each node */
+            opts_p->node_offset_check = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW: /* size the windows from a pilot run and the error rate */
+            opts_p->adaptive_window = 1;
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_PILOT: /* number of pilot windows */
+            opts_p->adaptive_window_pilot = atol(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_BATCH: /* number of windows between two window size adjustments */
+            opts_p->adaptive_window_batch = atol(optarg);
+            break;
+
+        case REPROMPI_ARGS_WINSYNC_SK_TOPOLOGY: /* communication pattern used to measure the offsets */
+            if (reprompi_parse_hca_topology(optarg, &(opts_p->sk_topology)) != 0
+                    || opts_p->sk_topology == HCA_TOPOLOGY_HIERARCHICAL) {
+              reprompib_print_error_and_exit("Invalid SKaMPI topology (--sk-topology=<linear|binomial>)");
+            }
+            break;
+
         case '?':
             break;
         }
@@ -71,9 +108,25 @@ void sk_parse_options(int argc, char **argv, reprompib_sync_options_t* opts_p) {
     if (opts_p->window_size_sec <= 0) {
       reprompib_print_error_and_exit("Invalid window size (should be positive)");
     }
+    if (opts_p->node_leader_sync && !reprompi_is_clock_shared(reprompi_get_clock())) {
+      reprompib_print_error_and_exit("--node-leader-sync requires a clock shared by the processes of a node "
+          "(--clock=<monotonic|monotonic_raw|realtime|RDTSC|RDTSCP>)");
+    }
     if (opts_p->wait_time_sec <= 0) {
       reprompib_print_error_and_exit("Invalid wait time before the first window (should be positive)");
     }
+    if (opts_p->hybrid_wait_spin_sec < 0) {
+      reprompib_print_error_and_exit("Invalid spin time of the hybrid wait (should be positive, or 0 to only spin)");
+    }
+    if (opts_p->sync_check_ranks < 0) {
+      reprompib_print_error_and_exit("Invalid number of ranks to check (should be positive, or 0 to disable the check)");
+    }
+    if (opts_p->adaptive_window_pilot <= 0) {
+      reprompib_print_error_and_exit("Invalid number of pilot windows (should be a positive integer)");
+    }
+    if (opts_p->adaptive_window_batch <= 0) {
+      reprompib_print_error_and_exit("Invalid number of windows per batch (should be a positive integer)");
+    }
 
     optind = 1;	// reset optind to enable option re-parsing
     opterr = 1; // reset opterr
@@ -39,6 +39,11 @@
 #include "reprompi_bench/misc.h"
 #include "reprompi_bench/sync/time_measurement.h"
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/node_sync.h"
+#include "reprompi_bench/sync/adaptive_window.h"
+#include "reprompi_bench/sync/sync_pingpong.h"
+#include "reprompi_bench/sync/sync_wait.h"
+#include "reprompi_bench/sync/sync_check.h"
 #include "sk_parse_options.h"
 #include "sk_sync.h"
 
@@ -46,27 +51,17 @@ double *tds; /* tds[i] is the time difference between the
  current node and global node i */
 
 static int *invalid; /* invalid[max_count_repetitions] */
+static double *start_errors; /* time between the start of each window and the end of the wait */
+static double *window_slack; /* time left in each window after the measurement (negative if the window expired) */
 static int repetition_counter;
 
-static double *ping_pong_min_time; /* ping_pong_min_time[i] is the minimum time of one ping_pong
- between the current node and node i, negative value means
- time not yet determined;
- needed to avoid measuring again all the 100 RTTs when re-synchronizing
- (in this case only a few ping-pongs are performed if the RTT stays
- within 110% for the ping_pong_min_time)
- */
-
 double start_batch, start_sync, stop_sync;
 static int sync_index = 0; /* current window index within the current measurement batch */
+static reprompi_adaptive_window_t adaptive_window;
 
 // options specified from the command line
 static reprompi_sk_options_t parameters;
 
-enum {
-    Number_ping_pongs = 100,
-    Minimum_ping_pongs = 8
-};
-
 
 void sk_init_synchronization_module(const reprompib_sync_options_t opts_p, const long nrep) {
     int i;
@@ -75,9 +70,17 @@ void sk_init_synchronization_module(const reprompib_sync_options_t opts_p, const
     MPI_Comm_size(MPI_COMM_WORLD, &np);
 
     parameters.wait_time_sec = opts_p.wait_time_sec;
+    parameters.hybrid_wait_spin_sec = opts_p.hybrid_wait_spin_sec;
+    parameters.sync_check_ranks = opts_p.sync_check_ranks;
+    parameters.output_file = opts_p.output_file;
     parameters.window_size_sec = opts_p.window_size_sec;
+    parameters.topology = opts_p.sk_topology;
+    parameters.node_leader_sync = opts_p.node_leader_sync;
+    parameters.node_offset_check = opts_p.node_offset_check;
     parameters.n_rep = nrep;
 
+    reprompi_adaptive_window_init(&adaptive_window, &opts_p);
+
     tds = (double*) skampi_malloc(np * sizeof(double));
     for (i = 0; i < np; i++)
         tds[i] = 0.0;
@@ -86,6 +89,12 @@ void sk_init_synchronization_module(const reprompib_sync_options_t opts_p, const
     for (i = 0; i < parameters.n_rep; i++) {
         invalid[i] = 0;
     }
+    start_errors = (double*) skampi_malloc(parameters.n_rep * sizeof(double));
+    window_slack = (double*) skampi_malloc(parameters.n_rep * sizeof(double));
+    for (i = 0; i < parameters.n_rep; i++) {
+        start_errors[i] = 0.0;
+        window_slack[i] = 0.0;
+    }
     repetition_counter = 0;
 
 }
@@ -141,132 +150,31 @@ void print_global_time_differences() {
 
 /*----------------------------------------------------------------------------*/
 
-static void ping_pong(int p1, int p2, int my_rank, int np) {
-    int i, other_global_id;
-    double s_now, s_last, t_last, t_now;
-    double td_min, td_max;
-    double invalid_time = -1.0;
-    MPI_Status status;
-    int pp_tag = 43;
-
-    ping_pong_min_time = (double*) skampi_malloc(
-            np * sizeof(double));
-    for (i = 0; i < np; i++)
-        ping_pong_min_time[i] = -1.0;
-
-    /* I had to unroll the main loop because I didn't find a portable way
-     to define the initial td_min and td_max with INFINITY and NINFINITY */
-    if (my_rank == p1) {
-        other_global_id = p2;
-
-        s_last = get_time();
-        MPI_Send(&s_last, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-        MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD, &status);
-        s_now = get_time();
-        MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-
-        td_min = t_last - s_now;
-        td_max = t_last - s_last;
-
-    } else {
-        other_global_id = p1;
-
-        MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD, &status);
-        t_last = get_time();
-        MPI_Send(&t_last, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD);
-        MPI_Recv(&s_now, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD, &status);
-        t_now = get_time();
-
-        td_min = s_last - t_last;
-        td_min = repro_max(td_min, s_now - t_now);
-
-        td_max = s_now - t_last;
-    }
-
-    if (my_rank == p1) {
-        i = 1;
-        while (1) {
-
-            MPI_Recv(&t_last, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD,
-                    &status);
-            if (t_last < 0.0) {
-                break;
-            }
-
-            s_last = s_now;
-            s_now = get_time();
-
-            td_min = repro_max(td_min, t_last - s_now);
-            td_max = repro_min(td_max, t_last - s_last);
-
-            if (ping_pong_min_time[other_global_id] >= 0.0
-                    && i >= Minimum_ping_pongs
-                    && s_now - s_last
-                    < ping_pong_min_time[other_global_id] * 1.10) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag,
-                        MPI_COMM_WORLD);
-                break;
-            }
-            i++;
-            if (i == Number_ping_pongs) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p2, pp_tag,
-                        MPI_COMM_WORLD);
-                break;
-            }
-            MPI_Send(&s_now, 1, MPI_DOUBLE, p2, pp_tag, MPI_COMM_WORLD);
-
-        }
-    } else {
-        i = 1;
-        while (1) {
-            MPI_Send(&t_now, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD);
-            MPI_Recv(&s_last, 1, MPI_DOUBLE, p1, pp_tag, MPI_COMM_WORLD,
-                    &status);
-            t_last = t_now;
-            t_now = get_time();
-
-            if (s_last < 0.0) {
-                break;
-            }
-
-            td_min = repro_max(td_min, s_last - t_now);
-            td_max = repro_min(td_max, s_last - t_last);
-
-            if (ping_pong_min_time[other_global_id] >= 0.0
-                    && i >= Minimum_ping_pongs
-                    && t_now - t_last
-                    < ping_pong_min_time[other_global_id] * 1.10) {
-                MPI_Send(&invalid_time, 1, MPI_DOUBLE, p1, pp_tag,
-                        MPI_COMM_WORLD);
-                break;
-            }
-            i++;
-        }
-    }
-
-    if (ping_pong_min_time[other_global_id] < 0.0) {
-        ping_pong_min_time[other_global_id] = td_max - td_min;
-    }
-    else {
-        ping_pong_min_time[other_global_id] = repro_min(
-                ping_pong_min_time[other_global_id], td_max - td_min);
-    }
-
-    tds[other_global_id] = (td_min + td_max) / 2.0;
-
-    free(ping_pong_min_time);
+/*
+ * the minimum ping-pong time of each pair is cached by the ping-pong engine, so that
+ * only a few ping-pongs are performed when re-synchronizing if the RTT stays within
+ * 110% of the cached value
+ */
+static void ping_pong(int p1, int p2, int my_rank, MPI_Comm comm) {
+    int other_id;
 
+    other_id = (my_rank == p1) ? p2 : p1;
+    tds[other_id] = reprompi_sync_pingpong_skampi_offset(p1, p2, comm, get_time);
 }
 
-void determine_time_differences(int my_rank, int np) {
+void determine_time_differences(MPI_Comm comm) {
     int i;
+    int my_rank, np;
     double *tmp_tds;
 
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
+
     //  measure ping-pong time between processes 0 and i
     for (i = 1; i < np; i++) {
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(comm);
         if (my_rank == 0 || my_rank == i)
-            ping_pong(0, i, my_rank, np);
+            ping_pong(0, i, my_rank, comm);
     }
 
     // send root time differences to all the other processes
@@ -278,7 +186,7 @@ void determine_time_differences(int my_rank, int np) {
 
     assert(np - 1 >= 0);
     MPI_Bcast(&(tmp_tds[1]), np - 1, MPI_DOUBLE, 0,
-            MPI_COMM_WORLD);
+            comm);
 
     // update local time differences
     if (my_rank != 0) {
@@ -287,36 +195,108 @@ void determine_time_differences(int my_rank, int np) {
         }
     }
     free(tmp_tds);
-    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(comm);
 
 }
 
 
-/*---------------------------------------------------------------------------*/
+/*
+ * Measure the offsets to rank 0 of comm along a binomial tree: in each of the
+ * O(log(p)) rounds, all processes that already know their offset to rank 0
+ * measure the offset of a new process in parallel and send it their own offset
+ * to rank 0, from which it derives its offset transitively.
+ * The offsets to all the other processes are then computed from the gathered
+ * offsets to rank 0.
+ */
+static void determine_time_differences_binomial(MPI_Comm comm) {
+    int i;
+    int my_rank, np;
+    int mask, partner;
+    double partner_td;
+    double *root_tds;
 
-int wait_till(double time_stamp, double *last_time_stamp) {
-    if ((*last_time_stamp = get_time()) > time_stamp) {
-        return 0;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &np);
+
+    tds[0] = 0.0;
+
+    mask = 1;
+    while (mask < np) {
+        mask <<= 1;
     }
-    else {
-        while ((*last_time_stamp = get_time()) < time_stamp) {
-            //
+
+    for (mask >>= 1; mask > 0; mask >>= 1) {
+        if (my_rank % (2 * mask) == 0) {
+            partner = my_rank + mask;
+            if (partner < np) {
+                ping_pong(my_rank, partner, my_rank, comm);
+                MPI_Send(&(tds[0]), 1, MPI_DOUBLE, partner, 0, comm);
+            }
+        } else if (my_rank % (2 * mask) == mask) {
+            partner = my_rank - mask;
+            ping_pong(partner, my_rank, my_rank, comm);
+            // offset to rank 0 = offset of my parent to rank 0 + offset to my parent
+            MPI_Recv(&partner_td, 1, MPI_DOUBLE, partner, 0, comm, MPI_STATUS_IGNORE);
+            tds[0] = partner_td + tds[partner];
         }
-        return 1;
     }
+
+    root_tds = (double*) skampi_malloc(np * sizeof(double));
+    MPI_Allgather(&(tds[0]), 1, MPI_DOUBLE, root_tds, 1, MPI_DOUBLE, comm);
+    for (i = 1; i < np; i++) {
+        tds[i] = tds[0] - root_tds[i];
+    }
+    free(root_tds);
+}
+
+
+static void sk_measure_time_differences(MPI_Comm comm) {
+    if (parameters.topology == HCA_TOPOLOGY_BINOMIAL) {
+        determine_time_differences_binomial(comm);
+    } else {
+        determine_time_differences(comm);
+    }
+}
+
+
+/*---------------------------------------------------------------------------*/
+
+int wait_till(double time_stamp, double *last_time_stamp) {
+    return reprompi_wait_until(time_stamp, get_time, parameters.hybrid_wait_spin_sec, last_time_stamp);
 }
 
 inline double should_wait_till(int counter, double interval, double offset) {
     return (counter + 1) * interval + start_batch + offset;
 }
 
+static double sk_get_global_time(void) {
+    return sk_get_normalized_time(get_time());
+}
+
 void sk_sync_clocks(void) {
-    int my_rank, np;
+    MPI_Comm node_comm, leaders_comm;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    if (!parameters.node_leader_sync && !parameters.node_offset_check) {
+        sk_measure_time_differences(MPI_COMM_WORLD);
+    } else {
+        reprompi_create_node_comms(&node_comm, &leaders_comm);
+        if (parameters.node_leader_sync) {
+            // only the leaders measure their offsets, the other processes share the clock of their leader
+            if (leaders_comm != MPI_COMM_NULL) {
+                sk_measure_time_differences(leaders_comm);
+            }
+            MPI_Bcast(&(tds[0]), 1, MPI_DOUBLE, 0, node_comm);
+        } else {
+            sk_measure_time_differences(MPI_COMM_WORLD);
+        }
+
+        if (parameters.node_offset_check) {
+            reprompi_check_node_offsets(node_comm, parameters.output_file, sk_get_global_time);
+        }
+        reprompi_free_node_comms(&node_comm, &leaders_comm);
+    }
 
-    determine_time_differences(my_rank, np);
+    reprompi_sync_check_begin(parameters.sync_check_ranks, parameters.output_file, get_time, sk_get_normalized_time);
 }
 
 void sk_init_synchronization(void) {
@@ -325,7 +305,13 @@ void sk_init_synchronization(void) {
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &np);
 
+    // the windows may be restarted several times for the same module (e.g., time-budgeted runs)
+    memset(invalid, 0, parameters.n_rep * sizeof(int));
+    memset(start_errors, 0, parameters.n_rep * sizeof(double));
+    memset(window_slack, 0, parameters.n_rep * sizeof(double));
+
     repetition_counter = 0;
+    sync_index = 0;
     if (my_rank == 0) {
         start_batch = get_time() + parameters.wait_time_sec;
     }
@@ -335,25 +321,43 @@ void sk_init_synchronization(void) {
 }
 
 void sk_start_synchronization(void) {
-    if (!wait_till(
-            should_wait_till(sync_index, parameters.window_size_sec, -tds[0]),
-            &start_sync)) {
+    double window_start;
+
+    window_start = should_wait_till(sync_index, parameters.window_size_sec, -tds[0]);
+    if (!wait_till(window_start, &start_sync)) {
         invalid[repetition_counter] |= FLAG_START_TIME_HAS_PASSED;
     }
     else {
         invalid[repetition_counter] = 0;
     }
+    start_errors[repetition_counter] = start_sync - window_start;
 }
 
 void sk_stop_synchronization(void) {
+    int my_rank;
+
     stop_sync = get_time();
 
     if (stop_sync - start_sync > parameters.window_size_sec) {
         invalid[repetition_counter] |= FLAG_SYNC_WIN_EXPIRED;
     }
+    // the window started start_errors[] before the end of the wait
+    window_slack[repetition_counter] = start_sync - start_errors[repetition_counter]
+            + parameters.window_size_sec - stop_sync;
 
     repetition_counter++;
     sync_index++;
+
+    if (reprompi_adaptive_window_update(&adaptive_window, stop_sync - start_sync,
+            invalid[repetition_counter - 1], &(parameters.window_size_sec))) {
+        // start a new batch of windows wait_time_sec after the current time of the root
+        MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+        if (my_rank == 0) {
+            start_batch = get_time() + parameters.wait_time_sec;
+        }
+        MPI_Bcast(&start_batch, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        sync_index = 0;
+    }
 }
 
 void print_sync_results(void) {
@@ -387,15 +391,34 @@ int* sk_get_local_sync_errorcodes(void) {
     return invalid;
 }
 
+double* sk_get_local_start_errors(void) {
+    return start_errors;
+}
+
+double* sk_get_local_window_slack(void) {
+    return window_slack;
+}
+
 void sk_cleanup_synchronization_module(void) {
+    reprompi_sync_check_end();
     free(tds);
     free(invalid);
+    free(start_errors);
+    free(window_slack);
+    reprompi_print_adaptive_window_sizes(&adaptive_window, parameters.output_file);
+    reprompi_adaptive_window_cleanup(&adaptive_window);
+    reprompi_sync_pingpong_cleanup();
 }
 
 void sk_print_sync_parameters(FILE* f) {
     fprintf(f, "#@sync=SKaMPI\n");
     fprintf(f, "#@window_s=%.10f\n", parameters.window_size_sec);
     fprintf(f, "#@wait_time_s=%.10f\n", parameters.wait_time_sec);
+    reprompi_print_wait_info(f, parameters.hybrid_wait_spin_sec);
+    fprintf(f, "#@sksynctype=%s\n", reprompi_get_hca_topology_name(parameters.topology));
+    reprompi_print_node_sync_info(f, parameters.node_leader_sync, parameters.node_offset_check);
+    reprompi_print_adaptive_window_info(f, &adaptive_window);
+    reprompi_print_sync_check_info(f, parameters.sync_check_ranks);
 }
 
 inline double sk_get_timediff_to_root(void) {
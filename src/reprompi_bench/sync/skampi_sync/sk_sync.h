@@ -36,6 +36,14 @@ typedef struct {
     double window_size_sec; /* --window-size */
 
     double wait_time_sec; /* --wait-time */
+    double hybrid_wait_spin_sec; /* --hybrid-wait */
+    int sync_check_ranks; /* --sync-check */
+    char* output_file; /* --output-file */
+
+    reprompi_hca_topology_t topology; /* --sk-topology */
+
+    int node_leader_sync; /* --node-leader-sync */
+    int node_offset_check; /* --node-offset-check */
 } reprompi_sk_options_t;
 
 
@@ -47,6 +55,8 @@ void sk_stop_synchronization(void);
 void sk_cleanup_synchronization_module(void);
 
 int* sk_get_local_sync_errorcodes(void);
+double* sk_get_local_start_errors(void);
+double* sk_get_local_window_slack(void);
 
 double sk_get_timediff_to_root(void);
 double sk_get_normalized_time(double local_time);
@@ -0,0 +1,186 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "mpi.h"
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+#include "sync_pingpong.h"
+#include "sync_check.h"
+
+static const int SYNC_CHECK_PINGPONGS = 20;
+
+static int n_check = 0;
+static const char* check_output_file = NULL;
+static double (*check_get_time)(void) = NULL;
+static double (*check_get_global_time)(double) = NULL;
+
+static int check_started = 0;
+static double start_offset = 0;
+static double start_time = 0;
+
+
+static double get_checked_global_time(void) {
+    return check_get_global_time(check_get_time());
+}
+
+
+/* the checked ranks are evenly spread over 1..np-1 */
+static int is_checked_rank(const int rank, const int np) {
+    int k;
+
+    if (rank == 0) {
+        return 0;
+    }
+    if (n_check >= np - 1) {
+        return 1;
+    }
+    for (k = 0; k < n_check; k++) {
+        if (1 + (int)(((long)k * (np - 1)) / n_check) == rank) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static void print_sync_check_results(FILE* f, const double max_offset, const double median_offset,
+        const double max_drift, const double interval) {
+    fprintf(f, "#@sync_check_offset_max_s=%.10f\n", max_offset);
+    fprintf(f, "#@sync_check_offset_median_s=%.10f\n", median_offset);
+    fprintf(f, "#@sync_check_drift_max=%.4e\n", max_drift);
+    fprintf(f, "#@sync_check_interval_s=%.6f\n", interval);
+}
+
+
+/* offset of the global time of the local process relative to the global time of rank 0 (0 on unchecked ranks) */
+static double measure_global_offset(void) {
+    int my_rank, np;
+    int p;
+    double offset = 0;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    for (p = 1; p < np; p++) {
+        if (is_checked_rank(p, np) && (my_rank == 0 || my_rank == p)) {
+            offset = reprompi_sync_pingpong_min_rtt_offset(p, 0, SYNC_CHECK_PINGPONGS, MPI_COMM_WORLD,
+                    get_checked_global_time, NULL);
+        }
+    }
+    return offset;
+}
+
+
+void reprompi_sync_check_begin(const int n_check_ranks, const char* output_file, double (*my_get_time)(void),
+        double (*get_global_time)(double)) {
+    n_check = n_check_ranks;
+    if (n_check <= 0) {
+        return;
+    }
+    check_output_file = output_file;
+    check_get_time = my_get_time;
+    check_get_global_time = get_global_time;
+
+    // a new synchronization replaces the reference of the previous one
+    start_offset = measure_global_offset();
+    start_time = get_checked_global_time();
+    check_started = 1;
+}
+
+
+void reprompi_sync_check_end(void) {
+    int my_rank, np;
+    int i, n_checked;
+    double end_offset, end_time;
+    double local_result[3];
+    double *all_results = NULL;
+    double *offsets = NULL;
+    double max_offset = 0, max_drift = 0, median_offset;
+    FILE* f;
+
+    if (n_check <= 0 || !check_started) {
+        return;
+    }
+    check_started = 0;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    end_offset = measure_global_offset();
+    end_time = get_checked_global_time();
+
+    local_result[0] = is_checked_rank(my_rank, np);
+    local_result[1] = fabs(end_offset);
+    local_result[2] = 0;
+    if (end_time > start_time) {
+        local_result[2] = fabs(end_offset - start_offset) / (end_time - start_time);
+    }
+
+    if (my_rank == 0) {
+        all_results = (double*) malloc(3 * np * sizeof(double));
+        offsets = (double*) malloc(np * sizeof(double));
+    }
+    MPI_Gather(local_result, 3, MPI_DOUBLE, all_results, 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // the check is repeated for every job, so the result is reported right away
+    if (my_rank == 0) {
+        n_checked = 0;
+        for (i = 0; i < np; i++) {
+            if (all_results[3 * i] > 0) {
+                offsets[n_checked++] = all_results[3 * i + 1];
+                if (all_results[3 * i + 1] > max_offset) {
+                    max_offset = all_results[3 * i + 1];
+                }
+                if (all_results[3 * i + 2] > max_drift) {
+                    max_drift = all_results[3 * i + 2];
+                }
+            }
+        }
+
+        if (n_checked > 0) {
+            gsl_sort(offsets, 1, n_checked);
+            median_offset = gsl_stats_median_from_sorted_data(offsets, 1, n_checked);
+            print_sync_check_results(stdout, max_offset, median_offset, max_drift, end_time - start_time);
+            if (check_output_file != NULL) {
+                f = fopen(check_output_file, "a");
+                print_sync_check_results(f, max_offset, median_offset, max_drift, end_time - start_time);
+                fflush(f);
+                fclose(f);
+            }
+        }
+
+        free(all_results);
+        free(offsets);
+    }
+}
+
+
+void reprompi_print_sync_check_info(FILE* f, const int n_check_ranks) {
+    if (n_check_ranks > 0) {
+        fprintf(f, "#@sync_check_ranks=%d\n", n_check_ranks);
+    }
+}
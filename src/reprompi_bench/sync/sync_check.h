@@ -0,0 +1,50 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_SYNC_CHECK_H_
+#define REPROMPI_SYNC_CHECK_H_
+
+#include <stdio.h>
+
+/*
+ * Validation of the global clock (--sync-check=<nranks>).
+ *
+ * reprompi_sync_check_begin is called by a synchronization module right after
+ * it synchronized the clocks, reprompi_sync_check_end when the module is cleaned
+ * up at the end of the job. Both measure the remaining offset between the global
+ * time of the checked ranks and the global time of rank 0 (min-RTT ping-pongs);
+ * reprompi_sync_check_end prints the maximum and median offset and the drift of
+ * the offsets between both checks on rank 0, to stdout and (if output_file is
+ * not NULL) appended to output_file.
+ *
+ * n_check_ranks ranks are checked, evenly spread over ranks 1..p-1 (all of them
+ * if n_check_ranks >= p-1); with n_check_ranks == 0 both functions do nothing.
+ * get_global_time converts the times returned by my_get_time to global times.
+ */
+void reprompi_sync_check_begin(const int n_check_ranks, const char* output_file, double (*my_get_time)(void),
+        double (*get_global_time)(double));
+void reprompi_sync_check_end(void);
+
+void reprompi_print_sync_check_info(FILE* f, const int n_check_ranks);
+
+#endif /* REPROMPI_SYNC_CHECK_H_ */
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <getopt.h>
 
 #include "sync_info.h"
@@ -33,6 +34,22 @@ const int REPROMPI_SYNC_N_EXCHANGES_DEFAULT = 10;
 
 const double REPROMPI_SYNC_WAIT_TIME_SEC_DEFAULT = 1e-3;
 const double REPROMPI_SYNC_WIN_SIZE_SEC_DEFAULT = 0;
+const double REPROMPI_SYNC_MODEL_TOLERANCE_SEC_DEFAULT = 1e-5;
+const long REPROMPI_SYNC_ADAPTIVE_WINDOW_PILOT_DEFAULT = 10;
+const long REPROMPI_SYNC_ADAPTIVE_WINDOW_BATCH_DEFAULT = 100;
+
+#ifdef ENABLE_LOGP_SYNC
+const reprompi_hca_topology_t REPROMPI_SYNC_HCA_TOPOLOGY_DEFAULT = HCA_TOPOLOGY_BINOMIAL;
+#else
+const reprompi_hca_topology_t REPROMPI_SYNC_HCA_TOPOLOGY_DEFAULT = HCA_TOPOLOGY_LINEAR;
+#endif
+
+static const char* const hca_topology_names[] = {
+        [HCA_TOPOLOGY_LINEAR] = "linear",
+        [HCA_TOPOLOGY_BINOMIAL] = "binomial",
+        [HCA_TOPOLOGY_HIERARCHICAL] = "hierarchical"
+};
+static const int N_HCA_TOPOLOGIES = 3;
 
 
 const struct option reprompi_sync_long_options[] = {
@@ -40,6 +57,28 @@ const struct option reprompi_sync_long_options[] = {
         { "fitpoints", required_argument, 0, REPROMPI_ARGS_WINSYNC_NFITPOINTS },
         { "exchanges", required_argument, 0, REPROMPI_ARGS_WINSYNC_NEXCHANGES },
         { "wait-time", required_argument, 0, REPROMPI_ARGS_WINSYNC_WAITTIME },
+        { "hca-topology", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_TOPOLOGY },
+        { "node-leader-sync", no_argument, 0, REPROMPI_ARGS_WINSYNC_NODE_LEADER_SYNC },
+        { "node-offset-check", no_argument, 0, REPROMPI_ARGS_WINSYNC_NODE_OFFSET_CHECK },
+        { "hca-resync-windows", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_RESYNC_WINDOWS },
+        { "hca-resync-time", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_RESYNC_TIME },
+        { "sync-model-cache", no_argument, 0, REPROMPI_ARGS_WINSYNC_MODEL_CACHE },
+        { "sync-model-tolerance", required_argument, 0, REPROMPI_ARGS_WINSYNC_MODEL_TOLERANCE },
+        { "sync-model-file", required_argument, 0, REPROMPI_ARGS_WINSYNC_MODEL_FILE },
+        { "adaptive-window", no_argument, 0, REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW },
+        { "adaptive-window-pilot", required_argument, 0, REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_PILOT },
+        { "adaptive-window-batch", required_argument, 0, REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_BATCH },
+        { "sk-topology", required_argument, 0, REPROMPI_ARGS_WINSYNC_SK_TOPOLOGY },
+        { "sync", required_argument, 0, REPROMPI_ARGS_SYNC_METHOD },
+        { "bbarrier", required_argument, 0, REPROMPI_ARGS_BBARRIER_TYPE },
+        { "bbarrier-skew", required_argument, 0, REPROMPI_ARGS_BBARRIER_SKEW },
+        { "hybrid-wait", required_argument, 0, REPROMPI_ARGS_WINSYNC_HYBRID_WAIT },
+        { "hca-drift-model", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_DRIFT_MODEL },
+        { "hca-offset-estimator", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_OFFSET_ESTIMATOR },
+        { "hca-offset-ci", required_argument, 0, REPROMPI_ARGS_WINSYNC_HCA_OFFSET_CI },
+        { "sync-check", required_argument, 0, REPROMPI_ARGS_WINSYNC_SYNC_CHECK },
+        { "clock", required_argument, 0, REPROMPI_ARGS_CLOCK },
+        { "sync-free", no_argument, 0, REPROMPI_ARGS_SYNC_FREE },
         { 0, 0, 0, 0 }
 };
 const char reprompi_sync_opts_str[] = "";
@@ -52,5 +91,48 @@ void reprompi_init_sync_parameters(reprompib_sync_options_t* opts_p) {
   opts_p->n_fitpoints = REPROMPI_SYNC_N_FITPOINTS_DEFAULT;
   opts_p->n_exchanges = REPROMPI_SYNC_N_EXCHANGES_DEFAULT;
   opts_p->wait_time_sec = REPROMPI_SYNC_WAIT_TIME_SEC_DEFAULT;
+  opts_p->hca_topology = REPROMPI_SYNC_HCA_TOPOLOGY_DEFAULT;
+  opts_p->sk_topology = HCA_TOPOLOGY_LINEAR;
+  opts_p->node_leader_sync = 0;
+  opts_p->node_offset_check = 0;
+  opts_p->hca_resync_windows = 0;
+  opts_p->hca_resync_time_sec = 0;
+  opts_p->hca_drift_model = HCA_DRIFT_MODEL_LINEAR;
+  opts_p->hca_offset_estimator = HCA_OFFSET_ESTIMATOR_MEDIAN;
+  opts_p->hca_offset_ci_sec = 0;
+  opts_p->sync_model_cache = 0;
+  opts_p->sync_model_tolerance_sec = REPROMPI_SYNC_MODEL_TOLERANCE_SEC_DEFAULT;
+  opts_p->sync_model_file = NULL;
+  opts_p->adaptive_window = 0;
+  opts_p->adaptive_window_pilot = REPROMPI_SYNC_ADAPTIVE_WINDOW_PILOT_DEFAULT;
+  opts_p->adaptive_window_batch = REPROMPI_SYNC_ADAPTIVE_WINDOW_BATCH_DEFAULT;
+  opts_p->bbarrier_skew_nrep = 0;
+  opts_p->hybrid_wait_spin_sec = 0;
+  opts_p->sync_check_ranks = 0;
+  opts_p->output_file = NULL;
+}
+
+
+const char* reprompi_get_hca_topology_name(reprompi_hca_topology_t topology) {
+  if (topology < 0 || topology >= N_HCA_TOPOLOGIES) {
+    return "unknown";
+  }
+  return hca_topology_names[topology];
+}
+
+
+/* returns 0 on success and 1 if the name does not match any topology */
+int reprompi_parse_hca_topology(const char* name, reprompi_hca_topology_t* topology) {
+  int i;
 
+  if (name == NULL) {
+    return 1;
+  }
+  for (i = 0; i < N_HCA_TOPOLOGIES; i++) {
+    if (strcmp(name, hca_topology_names[i]) == 0) {
+      *topology = (reprompi_hca_topology_t)i;
+      return 0;
+    }
+  }
+  return 1;
 }
@@ -32,12 +32,61 @@ enum {
     FLAG_SYNC_WIN_EXPIRED = 0x2
 };
 
+typedef enum {
+    HCA_TOPOLOGY_LINEAR = 0,    /* slopes along a binomial tree, intercepts one rank at a time against the root */
+    HCA_TOPOLOGY_BINOMIAL,      /* slopes and intercepts along a binomial tree, O(log(p)) rounds */
+    HCA_TOPOLOGY_HIERARCHICAL   /* binomial tree within each node, then binomial tree across node leaders */
+} reprompi_hca_topology_t;
+
+typedef enum {
+    HCA_DRIFT_MODEL_LINEAR = 0,     /* least-squares line */
+    HCA_DRIFT_MODEL_THEILSEN,       /* line through the median of the pairwise slopes */
+    HCA_DRIFT_MODEL_QUADRATIC,      /* least-squares parabola */
+    HCA_DRIFT_MODEL_PIECEWISE,      /* continuous piecewise-linear fit with automatically placed breakpoints */
+    HCA_DRIFT_MODEL_RANSAC,         /* least-squares line through the largest consensus set of the fit points */
+    HCA_DRIFT_MODEL_AUTO            /* model with the lowest leave-one-out prediction error */
+} reprompi_hca_drift_model_t;
+
+typedef enum {
+    HCA_OFFSET_ESTIMATOR_MEDIAN = 0,    /* median offset of the exchanges */
+    HCA_OFFSET_ESTIMATOR_MINRTT,        /* offset of the exchange with the smallest round-trip time */
+    HCA_OFFSET_ESTIMATOR_HUBER          /* Huber M-estimate of the offsets */
+} reprompi_hca_offset_estimator_t;
+
 typedef struct {
     double window_size_sec; /* --window-size */
     int n_fitpoints; /* --fitpoints */
     int n_exchanges; /* --exchanges */
 
     double wait_time_sec; /* --wait-time */
+
+    reprompi_hca_topology_t hca_topology; /* --hca-topology */
+    reprompi_hca_topology_t sk_topology; /* --sk-topology (linear or binomial) */
+
+    int node_leader_sync; /* --node-leader-sync */
+    int node_offset_check; /* --node-offset-check */
+
+    long hca_resync_windows; /* --hca-resync-windows */
+    double hca_resync_time_sec; /* --hca-resync-time */
+    reprompi_hca_drift_model_t hca_drift_model; /* --hca-drift-model */
+    reprompi_hca_offset_estimator_t hca_offset_estimator; /* --hca-offset-estimator */
+    double hca_offset_ci_sec; /* --hca-offset-ci */
+
+    int sync_model_cache; /* --sync-model-cache */
+    double sync_model_tolerance_sec; /* --sync-model-tolerance */
+    char* sync_model_file; /* --sync-model-file */
+
+    int adaptive_window; /* --adaptive-window */
+    long adaptive_window_pilot; /* --adaptive-window-pilot */
+    long adaptive_window_batch; /* --adaptive-window-batch */
+
+    long bbarrier_skew_nrep; /* --bbarrier-skew */
+
+    double hybrid_wait_spin_sec; /* --hybrid-wait */
+
+    int sync_check_ranks; /* --sync-check */
+
+    char* output_file; /* --output-file of the benchmark, set by the caller (NULL: results on stdout only) */
 } reprompib_sync_options_t;
 
 
@@ -45,7 +94,29 @@ typedef enum reprompi_win_sync_getopt_ids {
   REPROMPI_ARGS_WINSYNC_WIN_SIZE = 700,
   REPROMPI_ARGS_WINSYNC_NFITPOINTS,
   REPROMPI_ARGS_WINSYNC_NEXCHANGES,
-  REPROMPI_ARGS_WINSYNC_WAITTIME
+  REPROMPI_ARGS_WINSYNC_WAITTIME,
+  REPROMPI_ARGS_WINSYNC_HCA_TOPOLOGY,
+  REPROMPI_ARGS_WINSYNC_NODE_LEADER_SYNC,
+  REPROMPI_ARGS_WINSYNC_NODE_OFFSET_CHECK,
+  REPROMPI_ARGS_WINSYNC_HCA_RESYNC_WINDOWS,
+  REPROMPI_ARGS_WINSYNC_HCA_RESYNC_TIME,
+  REPROMPI_ARGS_WINSYNC_MODEL_CACHE,
+  REPROMPI_ARGS_WINSYNC_MODEL_TOLERANCE,
+  REPROMPI_ARGS_WINSYNC_MODEL_FILE,
+  REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW,
+  REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_PILOT,
+  REPROMPI_ARGS_WINSYNC_ADAPTIVE_WINDOW_BATCH,
+  REPROMPI_ARGS_WINSYNC_SK_TOPOLOGY,
+  REPROMPI_ARGS_SYNC_METHOD,
+  REPROMPI_ARGS_BBARRIER_TYPE,
+  REPROMPI_ARGS_BBARRIER_SKEW,
+  REPROMPI_ARGS_WINSYNC_HYBRID_WAIT,
+  REPROMPI_ARGS_WINSYNC_HCA_DRIFT_MODEL,
+  REPROMPI_ARGS_WINSYNC_HCA_OFFSET_ESTIMATOR,
+  REPROMPI_ARGS_WINSYNC_HCA_OFFSET_CI,
+  REPROMPI_ARGS_WINSYNC_SYNC_CHECK,
+  REPROMPI_ARGS_CLOCK,
+  REPROMPI_ARGS_SYNC_FREE
 } reprompi_win_sync_getopt_ids_t;
 
 extern const struct option reprompi_sync_long_options[];
@@ -54,4 +125,7 @@ extern const char reprompi_sync_opts_str[];
 
 void reprompi_init_sync_parameters(reprompib_sync_options_t* opts_p);
 
+const char* reprompi_get_hca_topology_name(reprompi_hca_topology_t topology);
+int reprompi_parse_hca_topology(const char* name, reprompi_hca_topology_t* topology);
+
 #endif /* REPROMPI_SYNC_PARSE_OPTIONS_H_ */
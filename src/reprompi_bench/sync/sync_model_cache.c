@@ -0,0 +1,259 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+// getline
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mpi.h"
+
+#include "sync_pingpong.h"
+#include "sync_model_cache.h"
+
+static const int SYNC_MODEL_ROOT = 0;
+static const int SYNC_MODEL_OFFSET_TAG = 49;
+
+
+double reprompi_measure_offset_to_root(double (*global_time)(void), const int n_pingpongs) {
+    int my_rank, np;
+    int p;
+    double offset = 0;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    for (p = 0; p < np; p++) {
+        if (p != SYNC_MODEL_ROOT && (my_rank == p || my_rank == SYNC_MODEL_ROOT)) {
+            offset = reprompi_sync_pingpong_min_rtt_offset(p, SYNC_MODEL_ROOT, n_pingpongs, MPI_COMM_WORLD,
+                    global_time, NULL);
+        }
+    }
+    return offset;
+}
+
+
+double reprompi_measure_offset_to_root_tree(double (*global_time)(void), const int n_pingpongs,
+        double* error_bound) {
+    int my_rank, np;
+    int mask;
+    double min_rtt;
+    double path[2] = { 0, 0 };  /* offset to the root and its error bound */
+    double parent_path[2];
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    // in round k, the processes 0..2^k-1 already know their offset to the root and
+    // each of them measures the offset of process rank+2^k (all pairs in parallel);
+    // the offsets (and the error bounds of half the minimum RTT) are then added along the path to the root
+    for (mask = 1; mask < np; mask <<= 1) {
+        if (my_rank < mask && my_rank + mask < np) {
+            reprompi_sync_pingpong_min_rtt_offset(my_rank + mask, my_rank, n_pingpongs, MPI_COMM_WORLD,
+                    global_time, NULL);
+            MPI_Send(path, 2, MPI_DOUBLE, my_rank + mask, SYNC_MODEL_OFFSET_TAG, MPI_COMM_WORLD);
+        } else if (my_rank >= mask && my_rank < 2 * mask) {
+            path[0] = reprompi_sync_pingpong_min_rtt_offset(my_rank, my_rank - mask, n_pingpongs,
+                    MPI_COMM_WORLD, global_time, &min_rtt);
+            path[1] = min_rtt / 2;
+            MPI_Recv(parent_path, 2, MPI_DOUBLE, my_rank - mask, SYNC_MODEL_OFFSET_TAG, MPI_COMM_WORLD,
+                    MPI_STATUS_IGNORE);
+            path[0] += parent_path[0];
+            path[1] += parent_path[1];
+        }
+    }
+    if (error_bound != NULL) {
+        *error_bound = path[1];
+    }
+    return path[0];
+}
+
+
+int reprompi_validate_sync_model(double (*global_time)(void), const int n_pingpongs,
+        const double tolerance_sec) {
+    double offset, error_bound, max_excess;
+
+    // only the part of the offset that cannot be explained by the measurement error counts
+    offset = fabs(reprompi_measure_offset_to_root_tree(global_time, n_pingpongs, &error_bound));
+    offset -= error_bound;
+    MPI_Allreduce(&offset, &max_excess, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    return (max_excess <= tolerance_sec);
+}
+
+
+/* comma-separated list of the host names of all processes (only on the root) */
+static char* get_hosts_key(void) {
+    int my_rank, np;
+    int i, name_len;
+    char my_name[MPI_MAX_PROCESSOR_NAME];
+    char* all_names = NULL;
+    char* key = NULL;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    memset(my_name, 0, MPI_MAX_PROCESSOR_NAME);
+    MPI_Get_processor_name(my_name, &name_len);
+
+    if (my_rank == SYNC_MODEL_ROOT) {
+        all_names = (char*) malloc(np * MPI_MAX_PROCESSOR_NAME * sizeof(char));
+    }
+    MPI_Gather(my_name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, all_names, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+            SYNC_MODEL_ROOT, MPI_COMM_WORLD);
+
+    if (my_rank == SYNC_MODEL_ROOT) {
+        key = (char*) calloc(np * (MPI_MAX_PROCESSOR_NAME + 1) + 1, sizeof(char));
+        for (i = 0; i < np; i++) {
+            if (i > 0) {
+                strcat(key, ",");
+            }
+            strncat(key, all_names + i * MPI_MAX_PROCESSOR_NAME, MPI_MAX_PROCESSOR_NAME);
+        }
+        free(all_names);
+    }
+    return key;
+}
+
+
+void reprompi_save_sync_model(const char* path, const double* model, const int n_values) {
+    int my_rank, np;
+    int p, i;
+    double* all_models = NULL;
+    char* key;
+    FILE* f;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    key = get_hosts_key();
+    if (my_rank == SYNC_MODEL_ROOT) {
+        all_models = (double*) malloc(np * n_values * sizeof(double));
+    }
+    MPI_Gather(model, n_values, MPI_DOUBLE, all_models, n_values, MPI_DOUBLE, SYNC_MODEL_ROOT, MPI_COMM_WORLD);
+
+    if (my_rank == SYNC_MODEL_ROOT) {
+        f = fopen(path, "w");
+        if (f == NULL) {
+            fprintf(stderr, "WARNING: Cannot write the synchronization models to %s\n", path);
+        } else {
+            fprintf(f, "#@sync_model_hosts=%s\n", key);
+            fprintf(f, "#@sync_model_nprocs=%d\n", np);
+            fprintf(f, "#@sync_model_values=%d\n", n_values);
+            for (p = 0; p < np; p++) {
+                fprintf(f, "%d", p);
+                for (i = 0; i < n_values; i++) {
+                    fprintf(f, " %.20e", all_models[p * n_values + i]);
+                }
+                fprintf(f, "\n");
+            }
+            fclose(f);
+        }
+        free(all_models);
+        free(key);
+    }
+}
+
+
+/* returns 1 if the root could read the models of all processes */
+static int read_sync_model_file(const char* path, const char* key, double* all_models,
+        const int np, const int n_values) {
+    FILE* f;
+    char* line = NULL;
+    size_t line_len = 0;
+    ssize_t nread;
+    int file_np, file_n_values;
+    int p, i, rank;
+    int valid = 0;
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return 0;
+    }
+
+    nread = getline(&line, &line_len, f);
+    if (nread > 0 && line[nread - 1] == '\n') {
+        line[nread - 1] = '\0';
+    }
+    if (nread > 0 && strncmp(line, "#@sync_model_hosts=", 19) == 0 && strcmp(line + 19, key) == 0
+            && fscanf(f, "#@sync_model_nprocs=%d\n", &file_np) == 1 && file_np == np
+            && fscanf(f, "#@sync_model_values=%d\n", &file_n_values) == 1 && file_n_values == n_values) {
+        valid = 1;
+        for (p = 0; p < np && valid; p++) {
+            if (fscanf(f, "%d", &rank) != 1 || rank != p) {
+                valid = 0;
+                break;
+            }
+            for (i = 0; i < n_values; i++) {
+                if (fscanf(f, "%lf", &all_models[p * n_values + i]) != 1) {
+                    valid = 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    free(line);
+    fclose(f);
+    return valid;
+}
+
+
+int reprompi_load_sync_model(const char* path, double* model, const int n_values) {
+    int my_rank, np;
+    double* all_models = NULL;
+    char* key;
+    int loaded = 0;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+
+    key = get_hosts_key();
+    if (my_rank == SYNC_MODEL_ROOT) {
+        all_models = (double*) malloc(np * n_values * sizeof(double));
+        loaded = read_sync_model_file(path, key, all_models, np, n_values);
+        free(key);
+    }
+
+    MPI_Bcast(&loaded, 1, MPI_INT, SYNC_MODEL_ROOT, MPI_COMM_WORLD);
+    if (loaded) {
+        MPI_Scatter(all_models, n_values, MPI_DOUBLE, model, n_values, MPI_DOUBLE, SYNC_MODEL_ROOT, MPI_COMM_WORLD);
+    }
+
+    free(all_models);
+    return loaded;
+}
+
+
+void reprompi_print_sync_model_cache_info(FILE* f, const int use_cache, const double tolerance_sec,
+        const char* path) {
+    if (use_cache) {
+        fprintf(f, "#@sync_model_cache=1\n");
+        fprintf(f, "#@sync_model_tolerance_s=%.10f\n", tolerance_sec);
+    }
+    if (path != NULL) {
+        fprintf(f, "#@sync_model_file=%s\n", path);
+    }
+}
@@ -0,0 +1,68 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_SYNC_MODEL_CACHE_H_
+#define REPROMPI_SYNC_MODEL_CACHE_H_
+
+#include <stdio.h>
+
+/*
+ * Measure the offset between the global time of each process and the global
+ * time of rank 0 (min-RTT estimate over n_pingpongs ping-pongs, one process at
+ * a time). Returns the offset of the calling process (0 on rank 0).
+ */
+double reprompi_measure_offset_to_root(double (*global_time)(void), const int n_pingpongs);
+
+/*
+ * Same as reprompi_measure_offset_to_root, but the offsets are measured along
+ * a binomial tree (ceil(log2 p) rounds of parallel ping-pongs instead of p-1
+ * consecutive ones) and added up along the path to rank 0, so that the errors
+ * of up to ceil(log2 p) measurements accumulate in each offset. If error_bound
+ * is not NULL, the sum of half the minimum RTTs along the path (the largest
+ * possible error of the offset) is stored there.
+ */
+double reprompi_measure_offset_to_root_tree(double (*global_time)(void), const int n_pingpongs,
+        double* error_bound);
+
+/*
+ * Check whether the current clock models are still usable: returns 1 on all
+ * processes if no offset to rank 0 (measured along a binomial tree) exceeds
+ * tolerance_sec by more than its error bound.
+ */
+int reprompi_validate_sync_model(double (*global_time)(void), const int n_pingpongs,
+        const double tolerance_sec);
+
+/*
+ * Save or load n_values model parameters per process. The file is keyed by
+ * the list of host names of all processes, a model is only loaded if the
+ * file was written by a job running on the same hosts with the same number
+ * of processes.
+ * reprompi_load_sync_model returns 1 on all processes if the model was loaded.
+ */
+void reprompi_save_sync_model(const char* path, const double* model, const int n_values);
+int reprompi_load_sync_model(const char* path, double* model, const int n_values);
+
+void reprompi_print_sync_model_cache_info(FILE* f, const int use_cache, const double tolerance_sec,
+        const char* path);
+
+#endif /* REPROMPI_SYNC_MODEL_CACHE_H_ */
@@ -0,0 +1,395 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mpi.h"
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+#include "reprompi_bench/misc.h"
+#include "sync_pingpong.h"
+
+// kinds of exchanges, each one uses its own tag and channels
+enum {
+    SKAMPI_CHANNEL = 0,
+    RTT_CHANNEL,
+    OFFSET_CHANNEL,
+    N_CHANNEL_TYPES
+};
+static const int channel_tags[N_CHANNEL_TYPES] = {
+    [SKAMPI_CHANNEL] = 43,
+    [RTT_CHANNEL] = 47,
+    [OFFSET_CHANNEL] = 48
+};
+
+enum {
+    Number_ping_pongs = 100,
+    Minimum_ping_pongs = 8
+};
+
+// per-pair caches indexed by the rank of the other process in MPI_COMM_WORLD (negative if unknown)
+static double* min_rtt_cache = NULL;
+static double* mean_rtt_cache = NULL;
+
+// preallocated buffer for the RTT measurements
+static double* rtt_buffer = NULL;
+static int rtt_buffer_size = 0;
+
+// a pair of persistent requests to exchange single timestamps with another process
+typedef struct {
+    double send_buf;
+    double recv_buf;
+    MPI_Request send_req;
+    MPI_Request recv_req;
+    int open;
+} pingpong_channel_t;
+
+// channels[type][r] is the channel to the process with rank r in MPI_COMM_WORLD,
+// opened when it is used for the first time
+static pingpong_channel_t* channels[N_CHANNEL_TYPES] = { NULL };
+static int n_channels = 0;
+
+
+static void init_caches(void) {
+    int i, np;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &np);
+    if (min_rtt_cache == NULL) {
+        min_rtt_cache = (double*) malloc(np * sizeof(double));
+        mean_rtt_cache = (double*) malloc(np * sizeof(double));
+        for (i = 0; i < np; i++) {
+            min_rtt_cache[i] = -1.0;
+            mean_rtt_cache[i] = -1.0;
+        }
+    }
+    if (channels[0] == NULL) {
+        n_channels = np;
+        for (i = 0; i < N_CHANNEL_TYPES; i++) {
+            channels[i] = (pingpong_channel_t*) calloc(np, sizeof(pingpong_channel_t));
+        }
+    }
+}
+
+static int get_world_rank(MPI_Comm comm, int rank) {
+    MPI_Group group, world_group;
+    int world_rank;
+
+    if (comm == MPI_COMM_WORLD) {
+        return rank;
+    }
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+    MPI_Group_translate_ranks(group, 1, &rank, world_group, &world_rank);
+    MPI_Group_free(&group);
+    MPI_Group_free(&world_group);
+
+    return world_rank;
+}
+
+/* channel of the given type to peer (rank in comm); all channels use MPI_COMM_WORLD */
+static pingpong_channel_t* get_channel(int type, int peer, MPI_Comm comm) {
+    int world_peer = get_world_rank(comm, peer);
+    pingpong_channel_t* ch = &(channels[type][world_peer]);
+
+    if (!ch->open) {
+        MPI_Send_init(&(ch->send_buf), 1, MPI_DOUBLE, world_peer, channel_tags[type], MPI_COMM_WORLD,
+                &(ch->send_req));
+        MPI_Recv_init(&(ch->recv_buf), 1, MPI_DOUBLE, world_peer, channel_tags[type], MPI_COMM_WORLD,
+                &(ch->recv_req));
+        ch->open = 1;
+    }
+    return ch;
+}
+
+
+void reprompi_sync_pingpong_reset_mean_rtt(void) {
+    int i;
+
+    if (mean_rtt_cache == NULL) {
+        return;
+    }
+    for (i = 0; i < n_channels; i++) {
+        mean_rtt_cache[i] = -1.0;
+    }
+}
+
+void reprompi_sync_pingpong_cleanup(void) {
+    int i, r;
+
+    for (i = 0; i < N_CHANNEL_TYPES; i++) {
+        if (channels[i] == NULL) {
+            continue;
+        }
+        for (r = 0; r < n_channels; r++) {
+            if (channels[i][r].open) {
+                MPI_Request_free(&(channels[i][r].send_req));
+                MPI_Request_free(&(channels[i][r].recv_req));
+            }
+        }
+        free(channels[i]);
+        channels[i] = NULL;
+    }
+}
+
+static inline void channel_send(pingpong_channel_t* ch, double value) {
+    ch->send_buf = value;
+    MPI_Start(&(ch->send_req));
+    MPI_Wait(&(ch->send_req), MPI_STATUS_IGNORE);
+}
+
+static inline double channel_recv(pingpong_channel_t* ch) {
+    MPI_Start(&(ch->recv_req));
+    MPI_Wait(&(ch->recv_req), MPI_STATUS_IGNORE);
+    return ch->recv_buf;
+}
+
+
+double reprompi_sync_pingpong_skampi_offset(int p1, int p2, MPI_Comm comm, double (*my_get_time)(void)) {
+    int i, my_rank, other_world_rank;
+    double s_now, s_last, t_last, t_now = 0;
+    double td_min, td_max;
+    double invalid_time = -1.0;
+    pingpong_channel_t* ch;
+
+    init_caches();
+    MPI_Comm_rank(comm, &my_rank);
+
+    if (my_rank == p1) {
+        other_world_rank = get_world_rank(comm, p2);
+        ch = get_channel(SKAMPI_CHANNEL, p2, comm);
+    } else {
+        other_world_rank = get_world_rank(comm, p1);
+        ch = get_channel(SKAMPI_CHANNEL, p1, comm);
+    }
+
+    /* I had to unroll the main loop because I didn't find a portable way
+     to define the initial td_min and td_max with INFINITY and NINFINITY */
+    if (my_rank == p1) {
+        s_last = my_get_time();
+        channel_send(ch, s_last);
+        t_last = channel_recv(ch);
+        s_now = my_get_time();
+        channel_send(ch, s_now);
+
+        td_min = t_last - s_now;
+        td_max = t_last - s_last;
+    } else {
+        s_last = channel_recv(ch);
+        t_last = my_get_time();
+        channel_send(ch, t_last);
+        s_now = channel_recv(ch);
+        t_now = my_get_time();
+
+        td_min = s_last - t_last;
+        td_min = repro_max(td_min, s_now - t_now);
+
+        td_max = s_now - t_last;
+    }
+
+    // stop as soon as a ping-pong is within 110% of the fastest one observed for this pair
+    if (my_rank == p1) {
+        i = 1;
+        while (1) {
+            t_last = channel_recv(ch);
+            if (t_last < 0.0) {
+                break;
+            }
+
+            s_last = s_now;
+            s_now = my_get_time();
+
+            td_min = repro_max(td_min, t_last - s_now);
+            td_max = repro_min(td_max, t_last - s_last);
+
+            if (min_rtt_cache[other_world_rank] >= 0.0 && i >= Minimum_ping_pongs
+                    && s_now - s_last < min_rtt_cache[other_world_rank] * 1.10) {
+                channel_send(ch, invalid_time);
+                break;
+            }
+            i++;
+            if (i == Number_ping_pongs) {
+                channel_send(ch, invalid_time);
+                break;
+            }
+            channel_send(ch, s_now);
+        }
+    } else {
+        i = 1;
+        while (1) {
+            channel_send(ch, t_now);
+            s_last = channel_recv(ch);
+            t_last = t_now;
+            t_now = my_get_time();
+
+            if (s_last < 0.0) {
+                break;
+            }
+
+            td_min = repro_max(td_min, s_last - t_now);
+            td_max = repro_min(td_max, s_last - t_last);
+
+            if (min_rtt_cache[other_world_rank] >= 0.0 && i >= Minimum_ping_pongs
+                    && t_now - t_last < min_rtt_cache[other_world_rank] * 1.10) {
+                channel_send(ch, invalid_time);
+                break;
+            }
+            i++;
+        }
+    }
+
+    if (min_rtt_cache[other_world_rank] < 0.0) {
+        min_rtt_cache[other_world_rank] = td_max - td_min;
+    } else {
+        min_rtt_cache[other_world_rank] = repro_min(min_rtt_cache[other_world_rank], td_max - td_min);
+    }
+
+    return (td_min + td_max) / 2.0;
+}
+
+
+double reprompi_sync_pingpong_mean_rtt(int master_rank, int other_rank, const int n_pingpongs,
+        const int n_warmup, MPI_Comm comm, double (*my_get_time)(void)) {
+    int i, my_rank, other_world_rank;
+    double tstart;
+    double upperq, cutoff_val, mean = 0;
+    int n_datapoints;
+    pingpong_channel_t* ch;
+
+    init_caches();
+    MPI_Comm_rank(comm, &my_rank);
+
+    if (my_rank == master_rank) {
+        other_world_rank = get_world_rank(comm, other_rank);
+    } else {
+        other_world_rank = get_world_rank(comm, master_rank);
+    }
+
+    // both processes of the pair cache the result, so they skip the measurement together
+    if (mean_rtt_cache[other_world_rank] >= 0.0) {
+        return mean_rtt_cache[other_world_rank];
+    }
+
+    if (my_rank == master_rank) {
+        ch = get_channel(RTT_CHANNEL, other_rank, comm);
+
+        /* warm up */
+        for (i = 0; i < n_warmup; i++) {
+            channel_send(ch, my_get_time());
+            channel_recv(ch);
+        }
+
+        if (rtt_buffer_size < n_pingpongs) {
+            free(rtt_buffer);
+            rtt_buffer = (double*) malloc(n_pingpongs * sizeof(double));
+            rtt_buffer_size = n_pingpongs;
+        }
+
+        for (i = 0; i < n_pingpongs; i++) {
+            tstart = my_get_time();
+            channel_send(ch, tstart);
+            channel_recv(ch);
+            rtt_buffer[i] = my_get_time() - tstart;
+        }
+
+        // discard the outliers above 1.5 times the upper quartile
+        gsl_sort(rtt_buffer, 1, n_pingpongs);
+        upperq = gsl_stats_quantile_from_sorted_data(rtt_buffer, 1, n_pingpongs, 0.75);
+        cutoff_val = 1.5 * upperq;
+
+        n_datapoints = 0;
+        while (n_datapoints < n_pingpongs && rtt_buffer[n_datapoints] <= cutoff_val) {
+            n_datapoints++;
+        }
+        mean = gsl_stats_mean(rtt_buffer, 1, n_datapoints);
+
+        if (min_rtt_cache[other_world_rank] < 0.0 || rtt_buffer[0] < min_rtt_cache[other_world_rank]) {
+            min_rtt_cache[other_world_rank] = rtt_buffer[0];
+        }
+
+        channel_send(ch, mean);
+    } else if (my_rank == other_rank) {
+        ch = get_channel(RTT_CHANNEL, master_rank, comm);
+
+        /* warm up */
+        for (i = 0; i < n_warmup; i++) {
+            channel_recv(ch);
+            channel_send(ch, my_get_time());
+        }
+
+        for (i = 0; i < n_pingpongs; i++) {
+            channel_recv(ch);
+            channel_send(ch, my_get_time());
+        }
+
+        mean = channel_recv(ch);
+    } else {
+        return 0;
+    }
+
+    mean_rtt_cache[other_world_rank] = mean;
+    return mean;
+}
+
+
+double reprompi_sync_pingpong_min_rtt_offset(int client, int server, const int n_pingpongs,
+        MPI_Comm comm, double (*my_get_time)(void), double* min_rtt_out) {
+    int i, my_rank, server_world_rank;
+    double tsend, tremote, trecv;
+    double min_rtt = -1, offset = 0;
+    pingpong_channel_t* ch;
+
+    init_caches();
+    MPI_Comm_rank(comm, &my_rank);
+
+    if (my_rank == client) {
+        ch = get_channel(OFFSET_CHANNEL, server, comm);
+        for (i = 0; i < n_pingpongs; i++) {
+            tsend = my_get_time();
+            channel_send(ch, tsend);
+            tremote = channel_recv(ch);
+            trecv = my_get_time();
+
+            if (min_rtt < 0 || trecv - tsend < min_rtt) {
+                min_rtt = trecv - tsend;
+                offset = (tsend + trecv) / 2.0 - tremote;
+            }
+        }
+
+        server_world_rank = get_world_rank(comm, server);
+        if (min_rtt_cache[server_world_rank] < 0.0 || min_rtt < min_rtt_cache[server_world_rank]) {
+            min_rtt_cache[server_world_rank] = min_rtt;
+        }
+        if (min_rtt_out != NULL) {
+            *min_rtt_out = min_rtt;
+        }
+    } else if (my_rank == server) {
+        ch = get_channel(OFFSET_CHANNEL, client, comm);
+        for (i = 0; i < n_pingpongs; i++) {
+            channel_recv(ch);
+            channel_send(ch, my_get_time());
+        }
+    }
+
+    return offset;
+}
@@ -0,0 +1,75 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_SYNC_PINGPONG_H_
+#define REPROMPI_SYNC_PINGPONG_H_
+
+#include "mpi.h"
+
+/*
+ * Ping-pong engine shared by the clock synchronization methods.
+ *
+ * All exchanges use persistent requests on preallocated buffers: one channel
+ * per kind of exchange and other process (on MPI_COMM_WORLD), created when it
+ * is used for the first time and freed by reprompi_sync_pingpong_cleanup. The engine
+ * caches per pair of processes (identified by their ranks in MPI_COMM_WORLD,
+ * so the cache is shared across communicators and jobs):
+ * - the minimum round-trip time, used to stop the SKaMPI ping-pongs early;
+ * - the mean round-trip time computed by reprompi_sync_pingpong_mean_rtt,
+ *   until it is reset by reprompi_sync_pingpong_reset_mean_rtt.
+ */
+
+/*
+ * SKaMPI offset measurement between p1 and p2 (ranks in comm).
+ * Returns the estimated offset of the clock of the other process relative to
+ * the local clock on both p1 and p2.
+ */
+double reprompi_sync_pingpong_skampi_offset(int p1, int p2, MPI_Comm comm, double (*my_get_time)(void));
+
+/*
+ * Mean round-trip time between master_rank and other_rank (after n_warmup
+ * warm-up exchanges, using n_pingpongs measurements without outliers).
+ * The result is cached per pair, so later calls for the same pair return
+ * the cached value without communication.
+ * Returns the mean RTT on both processes.
+ */
+double reprompi_sync_pingpong_mean_rtt(int master_rank, int other_rank, const int n_pingpongs,
+        const int n_warmup, MPI_Comm comm, double (*my_get_time)(void));
+
+/*
+ * Offset of the clock of client relative to the clock of server, estimated from
+ * the ping-pong with the smallest RTT out of n_pingpongs.
+ * Returns the offset on client (0 on server). If min_rtt is not NULL, the
+ * smallest RTT is stored there on client; the error of the offset is at most
+ * half of it.
+ */
+double reprompi_sync_pingpong_min_rtt_offset(int client, int server, const int n_pingpongs,
+        MPI_Comm comm, double (*my_get_time)(void), double* min_rtt);
+
+/* discards the cached mean RTTs, so the next reprompi_sync_pingpong_mean_rtt measures again */
+void reprompi_sync_pingpong_reset_mean_rtt(void);
+
+/* frees the persistent requests of all channels (the RTT caches are kept) */
+void reprompi_sync_pingpong_cleanup(void);
+
+#endif /* REPROMPI_SYNC_PINGPONG_H_ */
@@ -0,0 +1,86 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+// clock_nanosleep
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <time.h>
+
+#include "sync_wait.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define CPU_RELAX()
+#endif
+
+
+static void sleep_for(const double sec) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)sec;
+    ts.tv_nsec = (long)((sec - (double)ts.tv_sec) * 1e9);
+    // an interrupted sleep returns early, which the caller handles by checking the time again
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+}
+
+
+int reprompi_wait_until(const double target_time, double (*get_current_time)(void),
+        const double spin_sec, double* exit_time) {
+    double now;
+
+    now = get_current_time();
+    if (now >= target_time) {
+        *exit_time = now;
+        return 0;
+    }
+
+    if (spin_sec > 0) {
+        // the sleep is relative, since get_current_time may not be based on CLOCK_MONOTONIC
+        while (target_time - now > spin_sec) {
+            sleep_for(target_time - now - spin_sec);
+            now = get_current_time();
+        }
+        while (now < target_time) {
+            CPU_RELAX();
+            now = get_current_time();
+        }
+    } else {
+        while (now < target_time) {
+            now = get_current_time();
+        }
+    }
+
+    *exit_time = now;
+    return 1;
+}
+
+
+void reprompi_print_wait_info(FILE* f, const double spin_sec) {
+    if (spin_sec > 0) {
+        fprintf(f, "#@hybrid_wait_spin_s=%.10f\n", spin_sec);
+    }
+}
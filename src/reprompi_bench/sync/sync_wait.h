@@ -0,0 +1,42 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_SYNC_WAIT_H_
+#define REPROMPI_SYNC_WAIT_H_
+
+#include <stdio.h>
+
+/*
+ * Wait until get_current_time() reaches target_time.
+ * With spin_sec > 0 (--hybrid-wait), the process sleeps with clock_nanosleep
+ * until spin_sec before the target and spins (with a pause instruction) only
+ * for the rest; with spin_sec == 0 it busy-waits for the whole time.
+ * Returns 0 if target_time had already passed when the function was called,
+ * 1 otherwise. *exit_time is set to the time at which the wait ended.
+ */
+int reprompi_wait_until(const double target_time, double (*get_current_time)(void),
+        const double spin_sec, double* exit_time);
+
+void reprompi_print_wait_info(FILE* f, const double spin_sec);
+
+#endif /* REPROMPI_SYNC_WAIT_H_ */
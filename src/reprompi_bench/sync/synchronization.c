@@ -25,143 +25,346 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
 #include "mpi.h"
 
+#include "reprompi_bench/misc.h"
 #include "synchronization.h"
 #include "time_measurement.h"
 
-#ifdef ENABLE_WINDOWSYNC_SK
 #include "skampi_sync/sk_sync.h"
 #include "skampi_sync/sk_parse_options.h"
-
-#elif  ENABLE_WINDOWSYNC_JK
 #include "joneskoenig_sync/jk_sync.h"
 #include "joneskoenig_sync/jk_parse_options.h"
-
-#elif ENABLE_WINDOWSYNC_HCA
-#include "hca_sync/hca_sync.h"
-#include "hca_sync/hca_parse_options.h"
-
-#elif ENABLE_GLOBAL_TIMES
 #include "hca_sync/hca_sync.h"
 #include "hca_sync/hca_parse_options.h"
 #include "mpibarrier_sync/barrier_sync.h"
-#endif
-
-#ifdef ENABLE_BENCHMARK_BARRIER
 #include "benchmark_barrier_sync/bbarrier_sync.h"
-#endif
 
-#ifndef ENABLE_WINDOWSYNC
-#include "mpibarrier_sync/barrier_sync.h"
+#if defined(ENABLE_WINDOWSYNC_SK)
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_SKAMPI;
+#elif defined(ENABLE_WINDOWSYNC_JK)
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_JK;
+#elif defined(ENABLE_WINDOWSYNC_HCA)
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_HCA;
+#elif defined(ENABLE_GLOBAL_TIMES) && defined(ENABLE_BENCHMARK_BARRIER)
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_BBARRIER_GLOBAL;
+#elif defined(ENABLE_GLOBAL_TIMES)
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_MPIBARRIER_GLOBAL;
+#elif defined(ENABLE_BENCHMARK_BARRIER)
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_BBARRIER;
+#else
+static const reprompi_sync_method_t REPROMPI_SYNC_METHOD_DEFAULT = REPROMPI_SYNC_MPIBARRIER;
 #endif
 
+static const char* const sync_method_names[] = {
+        [REPROMPI_SYNC_MPIBARRIER] = "MPI_Barrier",
+        [REPROMPI_SYNC_BBARRIER] = "BBarrier",
+        [REPROMPI_SYNC_SKAMPI] = "SKaMPI",
+        [REPROMPI_SYNC_JK] = "JK",
+        [REPROMPI_SYNC_HCA] = "HCA",
+        [REPROMPI_SYNC_MPIBARRIER_GLOBAL] = "MPI_Barrier_global",
+        [REPROMPI_SYNC_BBARRIER_GLOBAL] = "BBarrier_global"
+};
+static const int N_SYNC_METHODS = 7;
+
+static int bbarrier_type_selected = 0;
+
+// --sync-free: the repetitions run back to back, the method only provides the clocks
+static int sync_free = 0;
+static init_sync_t method_init_sync = NULL;
+static print_sync_info_t method_print_sync_info = NULL;
+
+
 void no_op(void) {
 
 }
 
 
-#ifdef ENABLE_WINDOWSYNC_SK
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
-{
-    sync_f->init_sync_module = sk_init_synchronization_module;
-    sync_f->init_sync = sk_init_synchronization;
-    sync_f->sync_clocks = sk_sync_clocks;
-    sync_f->start_sync = sk_start_synchronization;
-    sync_f->stop_sync = sk_stop_synchronization;
-    sync_f->clean_sync_module = sk_cleanup_synchronization_module;
-    sync_f->get_normalized_time = sk_get_normalized_time;
-    sync_f->get_errorcodes = sk_get_local_sync_errorcodes;
-    sync_f->print_sync_info = sk_print_sync_parameters;
-    sync_f->get_time = get_time;
-    sync_f->parse_sync_params = sk_parse_options;
-}
-
-#elif ENABLE_WINDOWSYNC_JK
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
-{
-    sync_f->init_sync_module = jk_init_synchronization_module;
-    sync_f->init_sync = jk_init_synchronization;
-    sync_f->sync_clocks = jk_sync_clocks;
-    sync_f->start_sync = jk_start_synchronization;
-    sync_f->stop_sync = jk_stop_synchronization;
-    sync_f->clean_sync_module = jk_cleanup_synchronization_module;
-    sync_f->get_normalized_time = jk_get_normalized_time;
-    sync_f->get_errorcodes = jk_get_local_sync_errorcodes;
-    sync_f->print_sync_info = jk_print_sync_parameters;
-    sync_f->get_time = get_time;
-    sync_f->parse_sync_params = jk_parse_options;
-}
-
-#elif ENABLE_WINDOWSYNC_HCA
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
-{
-    sync_f->init_sync_module = hca_init_synchronization_module;
-    sync_f->sync_clocks = hca_synchronize_clocks;
-    sync_f->init_sync = hca_init_synchronization;
-    sync_f->clean_sync_module = hca_cleanup_synchronization_module;
-    sync_f->get_normalized_time = hca_get_normalized_time;
-    sync_f->get_errorcodes = hca_get_local_sync_errorcodes;
-
-    sync_f->print_sync_info = hca_print_sync_parameters;
-    sync_f->start_sync = hca_start_synchronization;
-    sync_f->stop_sync = hca_stop_synchronization;
-    sync_f->get_time = hca_get_adjusted_time;
-    sync_f->parse_sync_params = hca_parse_options;
-}
-
-#elif ENABLE_GLOBAL_TIMES // barrier sync with HCA-global times
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
-{
-    sync_f->init_sync_module = hca_init_synchronization_module;
-    sync_f->sync_clocks = hca_synchronize_clocks;
-    sync_f->init_sync = hca_init_synchronization;
-    sync_f->clean_sync_module = hca_cleanup_synchronization_module;
-    sync_f->get_normalized_time = hca_get_normalized_time;
-    sync_f->get_errorcodes = hca_get_local_sync_errorcodes;
-    sync_f->get_time = hca_get_adjusted_time;
-    sync_f->parse_sync_params = hca_parse_options;
-
-#if ENABLE_BENCHMARK_BARRIER
-    sync_f->print_sync_info = bbarrier_print_sync_parameters;
-    sync_f->start_sync = bbarrier_start_synchronization;
-    sync_f->stop_sync = bbarrier_stop_synchronization;
-#else	// MPI_Barrier sync
-    sync_f->print_sync_info = mpibarrier_print_sync_parameters;
-    sync_f->start_sync = mpibarrier_start_synchronization;
-    sync_f->stop_sync = mpibarrier_stop_synchronization;
-#endif
+const char* reprompi_get_sync_method_name(reprompi_sync_method_t method) {
+  if (method < 0 || method >= N_SYNC_METHODS) {
+    return "unknown";
+  }
+  return sync_method_names[method];
 }
 
-#elif ENABLE_BENCHMARK_BARRIER
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f)
-{
-    sync_f->init_sync_module = bbarrier_init_synchronization_module;
-    sync_f->sync_clocks = no_op;
-    sync_f->init_sync = bbarrier_init_synchronization;
-    sync_f->start_sync = bbarrier_start_synchronization;
-    sync_f->stop_sync = bbarrier_stop_synchronization;
-    sync_f->clean_sync_module = bbarrier_cleanup_synchronization_module;
-    sync_f->get_normalized_time = bbarrier_get_normalized_time;
-    sync_f->get_errorcodes = NULL;
-    sync_f->print_sync_info = bbarrier_print_sync_parameters;
-    sync_f->get_time = get_time;
-    sync_f->parse_sync_params = bbarrier_parse_options;
-}
-
-#else	// MPI_Barrier
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f) {
-    sync_f->init_sync_module = mpibarrier_init_synchronization_module;
-    sync_f->sync_clocks = no_op;
-    sync_f->init_sync = mpibarrier_init_synchronization;
-    sync_f->start_sync = mpibarrier_start_synchronization;
-    sync_f->stop_sync = mpibarrier_stop_synchronization;
-    sync_f->clean_sync_module = mpibarrier_cleanup_synchronization_module;
-    sync_f->get_normalized_time = mpibarrier_get_normalized_time;
-    sync_f->get_errorcodes = NULL;
-    sync_f->print_sync_info = mpibarrier_print_sync_parameters;
-    sync_f->get_time = get_time;
-    sync_f->parse_sync_params = mpibarrier_parse_options;
+
+/* returns 0 on success and 1 if the name does not match any method (case-insensitive) */
+int reprompi_parse_sync_method(const char* name, reprompi_sync_method_t* method) {
+  int i;
+
+  if (name == NULL) {
+    return 1;
+  }
+  for (i = 0; i < N_SYNC_METHODS; i++) {
+    if (strcasecmp(name, sync_method_names[i]) == 0) {
+      *method = (reprompi_sync_method_t)i;
+      return 0;
+    }
+  }
+  return 1;
 }
 
-#endif
+
+/* --sync and --bbarrier are parsed for all methods, since the BBarrier call uses the selected barrier too */
+static reprompi_sync_method_t parse_sync_method_options(int argc, char** argv) {
+    int c;
+    reprompi_sync_method_t method = REPROMPI_SYNC_METHOD_DEFAULT;
+
+    optind = 1;
+    optopt = 0;
+    opterr = 0; // ignore invalid options
+    while (1) {
+
+        /* getopt_long stores the option index here. */
+        int option_index = 0;
+
+        c = getopt_long(argc, argv, reprompi_sync_opts_str, reprompi_sync_long_options,
+                &option_index);
+
+        /* Detect the end of the options. */
+        if (c == -1)
+            break;
+
+        switch (c) {
+        case REPROMPI_ARGS_SYNC_METHOD:
+            if (reprompi_parse_sync_method(optarg, &method) != 0) {
+                reprompib_print_error_and_exit("Invalid synchronization method (use MPI_Barrier, BBarrier, SKaMPI, JK, HCA, MPI_Barrier_global or BBarrier_global)");
+            }
+            break;
+        case REPROMPI_ARGS_BBARRIER_TYPE: {
+            reprompi_bbarrier_type_t type;
+            if (reprompi_parse_bbarrier_type(optarg, &type) != 0) {
+                reprompib_print_error_and_exit("Invalid benchmark barrier (use dissemination, tournament, butterfly or hierarchical)");
+            }
+            reprompi_bbarrier_set_type(type);
+            bbarrier_type_selected = 1;
+            break;
+        }
+        case REPROMPI_ARGS_CLOCK: {
+            reprompi_clock_type_t clock;
+            if (reprompi_get_clock_by_name(optarg, &clock) != 0) {
+                reprompib_print_error_and_exit("Invalid clock (use MPI_Wtime, monotonic, monotonic_raw, realtime, RDTSC or RDTSCP)");
+            }
+            if (!reprompi_is_clock_available(clock)) {
+                reprompib_print_error_and_exit("Clock not available on this platform");
+            }
+            reprompi_select_clock(clock);
+            break;
+        }
+        case REPROMPI_ARGS_SYNC_FREE:
+            sync_free = 1;
+            break;
+        case '?':
+            break;
+        }
+    }
+
+    optind = 1; // reset optind to enable option re-parsing
+    opterr = 1; // reset opterr to catch invalid options
+    return method;
+}
+
+
+/* the barrier used by the BBarrier call when the synchronization does not use it */
+static void print_bbarrier_type(FILE* f) {
+    if (bbarrier_type_selected) {
+        fprintf(f, "#@bbarrier=%s\n", reprompi_get_bbarrier_name(reprompi_bbarrier_get_type()));
+    }
+}
+
+/* each method reports whether its timestamps are local or global */
+static void mpibarrier_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=local\n");
+    mpibarrier_print_sync_parameters(f);
+    print_bbarrier_type(f);
+}
+
+static void bbarrier_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=local\n");
+    bbarrier_print_sync_parameters(f);
+}
+
+static void sk_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=global\n");
+    sk_print_sync_parameters(f);
+    print_bbarrier_type(f);
+}
+
+static void jk_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=global\n");
+    jk_print_sync_parameters(f);
+    print_bbarrier_type(f);
+}
+
+static void hca_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=global\n");
+    hca_print_sync_parameters(f);
+    print_bbarrier_type(f);
+}
+
+static void mpibarrier_global_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=global\n");
+    hca_print_sync_type(f);
+    mpibarrier_print_sync_parameters(f);
+    print_bbarrier_type(f);
+}
+
+static void bbarrier_global_print_sync_info(FILE* f) {
+    fprintf(f, "#@clocktype=global\n");
+    hca_print_sync_type(f);
+    bbarrier_print_sync_parameters(f);
+}
+
+/* all processes start the first repetition together, the others follow without synchronization */
+static void sync_free_init_synchronization(void) {
+    method_init_sync();
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+static void sync_free_print_sync_info(FILE* f) {
+    method_print_sync_info(f);
+    fprintf(f, "#@sync_free=1\n");
+}
+
+/*
+ * Keeps the clock synchronization and the global times of the method, but
+ * removes the synchronization before and after each repetition. The local
+ * timestamps are only converted to global times when the runtimes are computed.
+ */
+static void set_sync_free(reprompib_sync_functions_t *sync_f) {
+    method_init_sync = sync_f->init_sync;
+    method_print_sync_info = sync_f->print_sync_info;
+
+    sync_f->init_sync = sync_free_init_synchronization;
+    sync_f->start_sync = no_op;
+    sync_f->stop_sync = no_op;
+    sync_f->get_start_errors = NULL;
+    sync_f->get_window_slack = NULL;
+    sync_f->print_sync_info = sync_free_print_sync_info;
+}
+
+
+void initialize_sync_implementation(int argc, char* argv[], reprompib_sync_functions_t *sync_f)
+{
+    sync_f->method = parse_sync_method_options(argc, argv);
+
+    switch (sync_f->method) {
+    case REPROMPI_SYNC_SKAMPI:
+        sync_f->init_sync_module = sk_init_synchronization_module;
+        sync_f->init_sync = sk_init_synchronization;
+        sync_f->sync_clocks = sk_sync_clocks;
+        sync_f->start_sync = sk_start_synchronization;
+        sync_f->stop_sync = sk_stop_synchronization;
+        sync_f->clean_sync_module = sk_cleanup_synchronization_module;
+        sync_f->get_normalized_time = sk_get_normalized_time;
+        sync_f->get_errorcodes = sk_get_local_sync_errorcodes;
+        sync_f->get_start_errors = sk_get_local_start_errors;
+        sync_f->get_window_slack = sk_get_local_window_slack;
+        sync_f->print_sync_info = sk_print_sync_info;
+        sync_f->get_time = get_time;
+        sync_f->ticks_to_time = ticks_to_sec;
+        sync_f->parse_sync_params = sk_parse_options;
+        break;
+
+    case REPROMPI_SYNC_JK:
+        sync_f->init_sync_module = jk_init_synchronization_module;
+        sync_f->init_sync = jk_init_synchronization;
+        sync_f->sync_clocks = jk_sync_clocks;
+        sync_f->start_sync = jk_start_synchronization;
+        sync_f->stop_sync = jk_stop_synchronization;
+        sync_f->clean_sync_module = jk_cleanup_synchronization_module;
+        sync_f->get_normalized_time = jk_get_normalized_time;
+        sync_f->get_errorcodes = jk_get_local_sync_errorcodes;
+        sync_f->get_start_errors = jk_get_local_start_errors;
+        sync_f->get_window_slack = jk_get_local_window_slack;
+        sync_f->print_sync_info = jk_print_sync_info;
+        sync_f->get_time = get_time;
+        sync_f->ticks_to_time = ticks_to_sec;
+        sync_f->parse_sync_params = jk_parse_options;
+        break;
+
+    case REPROMPI_SYNC_HCA:
+        sync_f->init_sync_module = hca_init_synchronization_module;
+        sync_f->sync_clocks = hca_synchronize_clocks;
+        sync_f->init_sync = hca_init_synchronization;
+        sync_f->clean_sync_module = hca_cleanup_synchronization_module;
+        sync_f->get_normalized_time = hca_get_normalized_time;
+        sync_f->get_errorcodes = hca_get_local_sync_errorcodes;
+        sync_f->get_start_errors = hca_get_local_start_errors;
+        sync_f->get_window_slack = hca_get_local_window_slack;
+        sync_f->print_sync_info = hca_print_sync_info;
+        sync_f->start_sync = hca_start_synchronization;
+        sync_f->stop_sync = hca_stop_synchronization;
+        sync_f->get_time = hca_get_adjusted_time;
+        sync_f->ticks_to_time = hca_ticks_to_adjusted_time;
+        sync_f->parse_sync_params = hca_parse_options;
+        break;
+
+    case REPROMPI_SYNC_MPIBARRIER_GLOBAL:   // barrier sync with HCA-global times
+    case REPROMPI_SYNC_BBARRIER_GLOBAL:
+        sync_f->init_sync_module = hca_init_synchronization_module;
+        sync_f->sync_clocks = hca_synchronize_clocks;
+        sync_f->init_sync = hca_init_synchronization;
+        sync_f->clean_sync_module = hca_cleanup_synchronization_module;
+        sync_f->get_normalized_time = hca_get_normalized_time;
+        sync_f->get_errorcodes = hca_get_local_sync_errorcodes;
+        sync_f->get_start_errors = NULL;
+        sync_f->get_window_slack = NULL;
+        sync_f->get_time = hca_get_adjusted_time;
+        sync_f->ticks_to_time = hca_ticks_to_adjusted_time;
+        sync_f->parse_sync_params = hca_parse_options;
+
+        if (sync_f->method == REPROMPI_SYNC_BBARRIER_GLOBAL) {
+            sync_f->print_sync_info = bbarrier_global_print_sync_info;
+            sync_f->start_sync = bbarrier_start_synchronization;
+            sync_f->stop_sync = bbarrier_stop_synchronization;
+        } else {    // MPI_Barrier sync
+            sync_f->print_sync_info = mpibarrier_global_print_sync_info;
+            sync_f->start_sync = mpibarrier_start_synchronization;
+            sync_f->stop_sync = mpibarrier_stop_synchronization;
+        }
+        break;
+
+    case REPROMPI_SYNC_BBARRIER:
+        sync_f->init_sync_module = bbarrier_init_synchronization_module;
+        sync_f->sync_clocks = no_op;
+        sync_f->init_sync = bbarrier_init_synchronization;
+        sync_f->start_sync = bbarrier_start_synchronization;
+        sync_f->stop_sync = bbarrier_stop_synchronization;
+        sync_f->clean_sync_module = bbarrier_cleanup_synchronization_module;
+        sync_f->get_normalized_time = bbarrier_get_normalized_time;
+        sync_f->get_errorcodes = NULL;
+        sync_f->get_start_errors = NULL;
+        sync_f->get_window_slack = NULL;
+        sync_f->print_sync_info = bbarrier_print_sync_info;
+        sync_f->get_time = get_time;
+        sync_f->ticks_to_time = ticks_to_sec;
+        sync_f->parse_sync_params = bbarrier_parse_options;
+        break;
+
+    case REPROMPI_SYNC_MPIBARRIER:
+    default:
+        sync_f->init_sync_module = mpibarrier_init_synchronization_module;
+        sync_f->sync_clocks = no_op;
+        sync_f->init_sync = mpibarrier_init_synchronization;
+        sync_f->start_sync = mpibarrier_start_synchronization;
+        sync_f->stop_sync = mpibarrier_stop_synchronization;
+        sync_f->clean_sync_module = mpibarrier_cleanup_synchronization_module;
+        sync_f->get_normalized_time = mpibarrier_get_normalized_time;
+        sync_f->get_errorcodes = NULL;
+        sync_f->get_start_errors = NULL;
+        sync_f->get_window_slack = NULL;
+        sync_f->print_sync_info = mpibarrier_print_sync_info;
+        sync_f->get_time = get_time;
+        sync_f->ticks_to_time = ticks_to_sec;
+        sync_f->parse_sync_params = mpibarrier_parse_options;
+        break;
+    }
+
+    if (sync_free) {
+        set_sync_free(sync_f);
+    }
+}
@@ -24,36 +24,22 @@
 #ifndef REPROMPIB_SYNCHRONIZATION_H_
 #define REPROMPIB_SYNCHRONIZATION_H_
 
+#include <stdio.h>
 #include "reprompi_bench/sync/sync_info.h"
+#include "reprompi_bench/sync/time_measurement.h"
 
-
-#if defined (ENABLE_WINDOWSYNC_SK)
-#define ENABLE_WINDOWSYNC
-#undef ENABLE_WINDOWSYNC_JK
-#undef ENABLE_WINDOWSYNC_HCA
-#undef ENABLE_GLOBAL_TIMES
-
-#elif defined (ENABLE_WINDOWSYNC_JK)
-#define ENABLE_WINDOWSYNC
-#undef ENABLE_WINDOWSYNC_SK
-#undef ENABLE_WINDOWSYNC_HCA
-#undef ENABLE_GLOBAL_TIMES
-
-#elif defined (ENABLE_WINDOWSYNC_HCA)
-#define ENABLE_WINDOWSYNC
-#undef ENABLE_WINDOWSYNC_JK
-#undef ENABLE_WINDOWSYNC_SK
-#undef ENABLE_GLOBAL_TIMES
-
-#else
-#undef ENABLE_WINDOWSYNC
-#endif
-
-#ifdef ENABLE_GLOBAL_TIMES
-#ifndef ENABLE_WINDOWSYNC
-#define ENABLE_WINDOWSYNC
-#endif
-#endif
+/* the compile-time flags (ENABLE_WINDOWSYNC_SK/JK/HCA, ENABLE_GLOBAL_TIMES,
+ * ENABLE_BENCHMARK_BARRIER) only select the default method;
+ * all methods are compiled in and can be selected with --sync */
+typedef enum {
+    REPROMPI_SYNC_MPIBARRIER = 0,       /* MPI_Barrier, local times */
+    REPROMPI_SYNC_BBARRIER,             /* dissemination barrier, local times */
+    REPROMPI_SYNC_SKAMPI,               /* SKaMPI windows, global times */
+    REPROMPI_SYNC_JK,                   /* Jones-Koenig windows, global times */
+    REPROMPI_SYNC_HCA,                  /* HCA windows, global times */
+    REPROMPI_SYNC_MPIBARRIER_GLOBAL,    /* MPI_Barrier, HCA global times */
+    REPROMPI_SYNC_BBARRIER_GLOBAL       /* dissemination barrier, HCA global times */
+} reprompi_sync_method_t;
 
 typedef void (*init_sync_module_t)(const reprompib_sync_options_t parsed_opts, const long nrep);
 typedef void (*sync_clocks_t)(void);
@@ -62,9 +48,12 @@ typedef void (*start_sync_t)(void);
 typedef void (*stop_sync_t)(void);
 typedef void (*cleanup_sync_t)(void);
 typedef int* (*sync_errorcodes_t)(void);
+typedef double* (*sync_start_errors_t)(void);
+typedef double* (*sync_window_slack_t)(void);
 typedef double (*sync_normtime_t)(double local_time);
 typedef void (*print_sync_info_t)(FILE* f);
 typedef double (*sync_time_t)(void);
+typedef double (*sync_ticks_to_time_t)(const reprompi_ticks_t ticks);
 typedef void (*parse_sync_params_t)(int argc, char** argv, reprompib_sync_options_t* parsed_opts);
 
 typedef struct {
@@ -76,11 +65,22 @@ typedef struct {
     cleanup_sync_t clean_sync_module;
     sync_normtime_t get_normalized_time;
     sync_errorcodes_t get_errorcodes;
+    sync_start_errors_t get_start_errors;
+    sync_window_slack_t get_window_slack;
     print_sync_info_t print_sync_info;
     sync_time_t get_time;
+    sync_ticks_to_time_t ticks_to_time;     /* converts get_ticks() values to the time base of get_time */
     parse_sync_params_t parse_sync_params;
+    reprompi_sync_method_t method;
 } reprompib_sync_functions_t;
 
-void initialize_sync_implementation(reprompib_sync_functions_t *sync_f);
+/* selects the method given by --sync (or the compile-time default);
+ * methods with local times set get_errorcodes to NULL, which the output
+ * functions use to choose between local and global runtimes;
+ * only the window-based methods provide get_start_errors and get_window_slack */
+void initialize_sync_implementation(int argc, char* argv[], reprompib_sync_functions_t *sync_f);
+
+const char* reprompi_get_sync_method_name(reprompi_sync_method_t method);
+int reprompi_parse_sync_method(const char* name, reprompi_sync_method_t* method);
 
 #endif /* REPROMPIB_SYNCHRONIZATION_H_ */
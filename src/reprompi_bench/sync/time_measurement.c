@@ -21,54 +21,465 @@
 </license>
 */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 #include "mpi.h"
 
-#if defined ENABLE_RDTSCP || defined ENABLE_RDTSC
+#include "time_measurement.h"
+#include "tsc_frequency.h"
+#ifdef REPROMPI_HAVE_TSC_CLOCKS
 #include "rdtsc.h"
 #endif
 
-#include "time_measurement.h"
+typedef double (*clock_get_time_t)(void);
+typedef reprompi_ticks_t (*clock_get_ticks_t)(void);
+
+typedef struct {
+    const char* name;
+    clock_get_time_t get_time;
+    clock_get_ticks_t get_ticks;
+    int tsc;    /* ticks are TSC ticks, nanoseconds otherwise */
+} reprompi_clock_t;
 
-#if defined ENABLE_RDTSCP || defined ENABLE_RDTSC
 #ifdef RDTSC_CALIBRATION
 static double FREQ_HZ=0;
+static reprompi_tsc_freq_source_t freq_source = TSC_FREQ_SOURCE_CALIBRATION;
 #elif FREQUENCY_MHZ		// Do not calibrate, set frequency to a fixed value
-const double FREQ_HZ=FREQUENCY_MHZ*1.0e6;
+static double FREQ_HZ=FREQUENCY_MHZ*1.0e6;
+static reprompi_tsc_freq_source_t freq_source = TSC_FREQ_SOURCE_FIXED;
 #else
-const double FREQ_HZ=2300*1.0e6;
-#endif
+static double FREQ_HZ=2300*1.0e6;
+static reprompi_tsc_freq_source_t freq_source = TSC_FREQ_SOURCE_FIXED;
 #endif
+static int tsc_initialized = 0;
+static int tsc_invariant = 0;     /* after gather_time_parameters: invariant TSC on all processes */
+static int tsc_warning_printed = 0;
+static double* all_freq_hz = NULL; /* frequency of each rank (only on rank 0, after gather_time_parameters) */
+static int n_freq = 0;
+static const double FREQ_LIST_REL_DIFF = 1e-5;
 
-void init_timer(void) {
-#ifdef RDTSC_CALIBRATION
-    uint64_t timerfreq = 0;
-    HRT_INIT(0 /* do not print */, timerfreq);
-    FREQ_HZ = (double)timerfreq;
+/* number of back-to-back reads used to estimate the overhead and resolution of each clock */
+static const int CLOCK_SURVEY_NREADS = 10000;
+static double clock_overhead_sec[REPROMPI_N_CLOCKS];
+static double clock_resolution_sec[REPROMPI_N_CLOCKS];
+static int clock_survey_done = 0;
+
+/* overhead and resolution of the timer used in the measurement loop (reprompi_calibrate_timer) */
+static const int TIMER_CALIBRATION_NROUNDS = 5;
+static const int TIMER_CALIBRATION_NREADS = 1000;
+static double timer_overhead_sec = 0;
+static double timer_resolution_sec = 0;
+static reprompi_ticks_t timer_overhead_ticks = 0;
+static double* all_timer_overhead_sec = NULL; /* only on rank 0 */
+static double* all_timer_resolution_sec = NULL;
+static int n_timer_calibration = 0;
+
+
+static double wtime_get_time(void) {
+    return MPI_Wtime();
+}
+
+static reprompi_ticks_t wtime_get_ticks(void) {
+    return (reprompi_ticks_t)(MPI_Wtime() * 1e9);
+}
+
+static inline double clock_gettime_sec(const clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline reprompi_ticks_t clock_gettime_ns(const clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (reprompi_ticks_t)ts.tv_sec * 1000000000ULL + (reprompi_ticks_t)ts.tv_nsec;
+}
+
+static double monotonic_get_time(void) {
+    return clock_gettime_sec(CLOCK_MONOTONIC);
+}
+
+static reprompi_ticks_t monotonic_get_ticks(void) {
+    return clock_gettime_ns(CLOCK_MONOTONIC);
+}
+
+#ifdef CLOCK_MONOTONIC_RAW
+static double monotonic_raw_get_time(void) {
+    return clock_gettime_sec(CLOCK_MONOTONIC_RAW);
+}
+
+static reprompi_ticks_t monotonic_raw_get_ticks(void) {
+    return clock_gettime_ns(CLOCK_MONOTONIC_RAW);
+}
 #endif
+
+static double realtime_get_time(void) {
+    return clock_gettime_sec(CLOCK_REALTIME);
 }
 
-inline double get_time(void) {
-#ifdef ENABLE_RDTSCP
-    return (double)rdtscp()/FREQ_HZ;
-#elif ENABLE_RDTSC
+static reprompi_ticks_t realtime_get_ticks(void) {
+    return clock_gettime_ns(CLOCK_REALTIME);
+}
+
+#ifdef REPROMPI_HAVE_TSC_CLOCKS
+static double rdtsc_get_time(void) {
     return (double)rdtsc()/FREQ_HZ;
+}
+
+static reprompi_ticks_t rdtsc_get_ticks(void) {
+    return rdtsc();
+}
+
+static double rdtscp_get_time(void) {
+    return (double)rdtscp()/FREQ_HZ;
+}
+
+static reprompi_ticks_t rdtscp_get_ticks(void) {
+    return rdtscp();
+}
+#endif
+
+/* clocks that are not available on this platform have no read functions */
+static const reprompi_clock_t clocks[REPROMPI_N_CLOCKS] = {
+        [REPROMPI_CLOCK_MPI_WTIME] = { "MPI_Wtime", wtime_get_time, wtime_get_ticks, 0 },
+        [REPROMPI_CLOCK_MONOTONIC] = { "monotonic", monotonic_get_time, monotonic_get_ticks, 0 },
+#ifdef CLOCK_MONOTONIC_RAW
+        [REPROMPI_CLOCK_MONOTONIC_RAW] = { "monotonic_raw", monotonic_raw_get_time, monotonic_raw_get_ticks, 0 },
 #else
-    return MPI_Wtime();
+        [REPROMPI_CLOCK_MONOTONIC_RAW] = { "monotonic_raw", NULL, NULL, 0 },
 #endif
+        [REPROMPI_CLOCK_REALTIME] = { "realtime", realtime_get_time, realtime_get_ticks, 0 },
+#ifdef REPROMPI_HAVE_TSC_CLOCKS
+        [REPROMPI_CLOCK_RDTSC] = { "RDTSC", rdtsc_get_time, rdtsc_get_ticks, 1 },
+        [REPROMPI_CLOCK_RDTSCP] = { "RDTSCP", rdtscp_get_time, rdtscp_get_ticks, 1 },
+#else
+        [REPROMPI_CLOCK_RDTSC] = { "RDTSC", NULL, NULL, 1 },
+        [REPROMPI_CLOCK_RDTSCP] = { "RDTSCP", NULL, NULL, 1 },
+#endif
+};
+
+// the compile-time flags only select the default clock, which can be changed with --clock
+#if defined ENABLE_RDTSCP && defined REPROMPI_HAVE_TSC_CLOCKS
+static reprompi_clock_type_t clock_type = REPROMPI_CLOCK_RDTSCP;
+static clock_get_time_t timer_get_time = rdtscp_get_time;
+static clock_get_ticks_t timer_get_ticks = rdtscp_get_ticks;
+#elif defined ENABLE_RDTSC && defined REPROMPI_HAVE_TSC_CLOCKS
+static reprompi_clock_type_t clock_type = REPROMPI_CLOCK_RDTSC;
+static clock_get_time_t timer_get_time = rdtsc_get_time;
+static clock_get_ticks_t timer_get_ticks = rdtsc_get_ticks;
+#else
+static reprompi_clock_type_t clock_type = REPROMPI_CLOCK_MPI_WTIME;
+static clock_get_time_t timer_get_time = wtime_get_time;
+static clock_get_ticks_t timer_get_ticks = wtime_get_ticks;
+#endif
+static double sec_per_tick = 1e-9;
+
+
+static void init_tsc_frequency(void) {
+    if (tsc_initialized) {
+        return;
+    }
+    tsc_invariant = reprompi_tsc_is_invariant();
+#ifdef RDTSC_CALIBRATION
+    FREQ_HZ = reprompi_tsc_discover_frequency(&freq_source);
+#endif
+    tsc_initialized = 1;
 }
 
-void print_time_parameters(FILE* f) {
-    char clock[10];
+/* may be called before MPI_Init, so the timer of each process is set up locally */
+void init_timer(void) {
+    const reprompi_clock_t* c = &clocks[clock_type];
+
+    sec_per_tick = 1e-9;
+    if (c->tsc) {
+        init_tsc_frequency();
+        sec_per_tick = 1.0 / FREQ_HZ;
+    }
+    timer_get_time = c->get_time;
+    timer_get_ticks = c->get_ticks;
+}
+
+int reprompi_is_clock_available(const reprompi_clock_type_t type) {
+    return ((int)type >= 0 && type < REPROMPI_N_CLOCKS && clocks[type].get_time != NULL);
+}
+
+void reprompi_select_clock(const reprompi_clock_type_t type) {
+    if (!reprompi_is_clock_available(type)) {
+        return;
+    }
+    clock_type = type;
+    init_timer();
+}
+
+reprompi_clock_type_t reprompi_get_clock(void) {
+    return clock_type;
+}
+
+int reprompi_is_clock_shared(const reprompi_clock_type_t type) {
+    return (reprompi_is_clock_available(type) && type != REPROMPI_CLOCK_MPI_WTIME);
+}
+
+const char* reprompi_get_clock_name(const reprompi_clock_type_t type) {
+    if ((int)type < 0 || type >= REPROMPI_N_CLOCKS) {
+        return "unknown";
+    }
+    return clocks[type].name;
+}
+
+int reprompi_get_clock_by_name(const char* name, reprompi_clock_type_t* type) {
+    int i;
+
+    for (i = 0; i < REPROMPI_N_CLOCKS; i++) {
+        if (strcasecmp(name, clocks[i].name) == 0) {
+            *type = (reprompi_clock_type_t) i;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Reads the clock CLOCK_SURVEY_NREADS times back-to-back. The overhead is the
+ * mean time between two reads, the resolution is the smallest non-zero step
+ * observed between two consecutive reads.
+ */
+static void survey_clock(const reprompi_clock_t* c, const double clock_sec_per_tick,
+        double* overhead_sec, double* resolution_sec) {
+    int i;
+    reprompi_ticks_t first, prev, now, min_step = 0;
+
+    first = prev = c->get_ticks();
+    for (i = 0; i < CLOCK_SURVEY_NREADS; i++) {
+        now = c->get_ticks();
+        if (now > prev && (min_step == 0 || now - prev < min_step)) {
+            min_step = now - prev;
+        }
+        prev = now;
+    }
+    *overhead_sec = (double)(prev - first) * clock_sec_per_tick / CLOCK_SURVEY_NREADS;
+    *resolution_sec = (double)min_step * clock_sec_per_tick;
+}
+
+static void survey_clocks(void) {
+    int i;
+    double clock_sec_per_tick;
+
+    for (i = 0; i < REPROMPI_N_CLOCKS; i++) {
+        if (clocks[i].get_ticks == NULL) {
+            continue;
+        }
+        clock_sec_per_tick = 1e-9;
+        if (clocks[i].tsc) {
+            init_tsc_frequency();
+            clock_sec_per_tick = 1.0 / FREQ_HZ;
+        }
+        survey_clock(&clocks[i], clock_sec_per_tick, &clock_overhead_sec[i], &clock_resolution_sec[i]);
+    }
+    clock_survey_done = 1;
+}
+
+void gather_time_parameters(void) {
+    int my_rank;
+    double freq = FREQ_HZ;
+    int local_invariant;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == 0 && !clock_survey_done) {
+        survey_clocks();
+    }
+
+    if (!clocks[clock_type].tsc) {
+        return;
+    }
+    local_invariant = reprompi_tsc_is_invariant();
+    if (my_rank == 0 && all_freq_hz == NULL) {
+        MPI_Comm_size(MPI_COMM_WORLD, &n_freq);
+        all_freq_hz = (double*) malloc(n_freq * sizeof(double));
+    }
+    MPI_Gather(&freq, 1, MPI_DOUBLE, all_freq_hz, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // the TSC is only usable as a timer if it is invariant on all processes
+    MPI_Allreduce(&local_invariant, &tsc_invariant, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (my_rank == 0 && !tsc_invariant && !tsc_warning_printed) {
+        fprintf(stderr, "WARNING: The TSC is not invariant on all processes, its rate may change with "
+                "the CPU frequency and power states (use a different --clock)\n");
+        tsc_warning_printed = 1;
+    }
+}
+
+/* the overhead is the mean time between two back-to-back calls in the fastest of several rounds */
+static void measure_timer_overhead(double (*get_time_fn)(void), double* overhead_sec, double* resolution_sec) {
+    int r, i;
+    double first, prev, now, mean_step;
+
+    *overhead_sec = -1;
+    *resolution_sec = 0;
+    for (r = 0; r < TIMER_CALIBRATION_NROUNDS; r++) {
+        first = prev = get_time_fn();
+        for (i = 0; i < TIMER_CALIBRATION_NREADS; i++) {
+            now = get_time_fn();
+            if (now > prev && (*resolution_sec == 0 || now - prev < *resolution_sec)) {
+                *resolution_sec = now - prev;
+            }
+            prev = now;
+        }
+        mean_step = (prev - first) / TIMER_CALIBRATION_NREADS;
+        if (*overhead_sec < 0 || mean_step < *overhead_sec) {
+            *overhead_sec = mean_step;
+        }
+    }
+}
+
+static void measure_ticks_overhead(reprompi_ticks_t* overhead_ticks, reprompi_ticks_t* resolution_ticks) {
+    int r, i;
+    reprompi_ticks_t first, prev, now, mean_step;
+
+    *overhead_ticks = 0;
+    *resolution_ticks = 0;
+    for (r = 0; r < TIMER_CALIBRATION_NROUNDS; r++) {
+        first = prev = get_ticks();
+        for (i = 0; i < TIMER_CALIBRATION_NREADS; i++) {
+            now = get_ticks();
+            if (now > prev && (*resolution_ticks == 0 || now - prev < *resolution_ticks)) {
+                *resolution_ticks = now - prev;
+            }
+            prev = now;
+        }
+        mean_step = (prev - first) / TIMER_CALIBRATION_NREADS;
+        if (r == 0 || mean_step < *overhead_ticks) {
+            *overhead_ticks = mean_step;
+        }
+    }
+}
+
+static void gather_timer_calibration(void) {
+    int my_rank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    if (my_rank == 0 && all_timer_overhead_sec == NULL) {
+        MPI_Comm_size(MPI_COMM_WORLD, &n_timer_calibration);
+        all_timer_overhead_sec = (double*) malloc(n_timer_calibration * sizeof(double));
+        all_timer_resolution_sec = (double*) malloc(n_timer_calibration * sizeof(double));
+    }
+    MPI_Gather(&timer_overhead_sec, 1, MPI_DOUBLE, all_timer_overhead_sec, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&timer_resolution_sec, 1, MPI_DOUBLE, all_timer_resolution_sec, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+}
+
+void reprompi_calibrate_timer(double (*get_time_fn)(void)) {
+    measure_timer_overhead(get_time_fn, &timer_overhead_sec, &timer_resolution_sec);
+    // the overhead in ticks is only an approximation here, it is measured exactly by reprompi_calibrate_ticks
+    timer_overhead_ticks = (reprompi_ticks_t)(timer_overhead_sec / sec_per_tick);
+    gather_timer_calibration();
+}
+
+void reprompi_calibrate_ticks(void) {
+    reprompi_ticks_t resolution_ticks;
+
+    measure_ticks_overhead(&timer_overhead_ticks, &resolution_ticks);
+    timer_overhead_sec = ticks_to_sec(timer_overhead_ticks);
+    timer_resolution_sec = ticks_to_sec(resolution_ticks);
+    gather_timer_calibration();
+}
+
+double reprompi_get_timer_overhead(void) {
+    return timer_overhead_sec;
+}
+
+reprompi_ticks_t reprompi_get_timer_overhead_ticks(void) {
+    return timer_overhead_ticks;
+}
+
+double get_time(void) {
+    return timer_get_time();
+}
+
+reprompi_ticks_t get_ticks(void) {
+    return timer_get_ticks();
+}
+
+double ticks_to_sec(const reprompi_ticks_t ticks) {
+    return (double)ticks * sec_per_tick;
+}
+
+static void print_tsc_parameters(FILE* f) {
+    int i;
+    double min_freq, max_freq;
 
-    strcpy(clock, "MPI_Wtime");
-#ifdef ENABLE_RDTSCP
-    strcpy(clock, "RDTSCP");
-    fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
-#elif ENABLE_RDTSC
-    strcpy(clock, "RDTSC");
     fprintf(f, "#@frequency_hz=%lf\n", FREQ_HZ);
-#endif
-    fprintf(f, "#@clock=%s\n", clock);
+    fprintf(f, "#@frequency_source=%s\n", reprompi_get_tsc_freq_source_name(freq_source));
+    fprintf(f, "#@tsc_invariant=%d\n", tsc_invariant);
+
+    if (all_freq_hz == NULL) {
+        return;
+    }
+    min_freq = max_freq = all_freq_hz[0];
+    for (i = 1; i < n_freq; i++) {
+        if (all_freq_hz[i] < min_freq) {
+            min_freq = all_freq_hz[i];
+        }
+        if (all_freq_hz[i] > max_freq) {
+            max_freq = all_freq_hz[i];
+        }
+    }
+    fprintf(f, "#@frequency_hz_min=%lf\n", min_freq);
+    fprintf(f, "#@frequency_hz_max=%lf\n", max_freq);
+    // the frequency of each rank is only listed if the frequencies differ by more than the calibration error
+    if (max_freq - min_freq > FREQ_LIST_REL_DIFF * min_freq) {
+        for (i = 0; i < n_freq; i++) {
+            fprintf(f, "#@frequency_hz_rank%d=%lf\n", i, all_freq_hz[i]);
+        }
+    }
+}
+
+static void print_min_mean_max(FILE* f, const char* key, const double* values, const int n) {
+    int i;
+    double min, max, sum;
+
+    min = max = sum = values[0];
+    for (i = 1; i < n; i++) {
+        if (values[i] < min) {
+            min = values[i];
+        }
+        if (values[i] > max) {
+            max = values[i];
+        }
+        sum += values[i];
+    }
+    fprintf(f, "#@%s_min=%.10f\n", key, min);
+    fprintf(f, "#@%s_mean=%.10f\n", key, sum / n);
+    fprintf(f, "#@%s_max=%.10f\n", key, max);
+}
+
+static void print_timer_calibration(FILE* f) {
+    if (all_timer_overhead_sec == NULL) {
+        return;
+    }
+    print_min_mean_max(f, "timer_overhead_s", all_timer_overhead_sec, n_timer_calibration);
+    print_min_mean_max(f, "timer_resolution_s", all_timer_resolution_sec, n_timer_calibration);
+}
+
+void print_time_parameters(FILE* f) {
+    int i;
+
+    if (clocks[clock_type].tsc) {
+        print_tsc_parameters(f);
+    }
+    fprintf(f, "#@clock=%s\n", clocks[clock_type].name);
+    print_timer_calibration(f);
+
+    if (!clock_survey_done) {
+        return;
+    }
+    for (i = 0; i < REPROMPI_N_CLOCKS; i++) {
+        if (clocks[i].get_ticks == NULL) {
+            continue;
+        }
+        fprintf(f, "#@clock_%s_overhead_s=%.10f\n", clocks[i].name, clock_overhead_sec[i]);
+        fprintf(f, "#@clock_%s_resolution_s=%.10f\n", clocks[i].name, clock_resolution_sec[i]);
+    }
 }
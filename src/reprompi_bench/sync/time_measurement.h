@@ -24,10 +24,62 @@
 #ifndef REPROMPIB_TIME_MEASUREMENT_H_
 #define REPROMPIB_TIME_MEASUREMENT_H_
 
+#include <stdio.h>
+#include <stdint.h>
+
+#if defined(__x86_64__)
+#define REPROMPI_HAVE_TSC_CLOCKS
+#endif
+
+/* raw timer value: TSC ticks with RDTSC/RDTSCP, nanoseconds otherwise */
+typedef uint64_t reprompi_ticks_t;
+
+typedef enum {
+    REPROMPI_CLOCK_MPI_WTIME = 0,
+    REPROMPI_CLOCK_MONOTONIC,       /* clock_gettime(CLOCK_MONOTONIC) */
+    REPROMPI_CLOCK_MONOTONIC_RAW,   /* clock_gettime(CLOCK_MONOTONIC_RAW), not slewed by NTP */
+    REPROMPI_CLOCK_REALTIME,        /* clock_gettime(CLOCK_REALTIME) */
+    REPROMPI_CLOCK_RDTSC,           /* x86-64 only */
+    REPROMPI_CLOCK_RDTSCP,          /* x86-64 only */
+    REPROMPI_N_CLOCKS
+} reprompi_clock_type_t;
+
+/* sets up the selected clock; may be called before MPI_Init */
 void init_timer(void);
 
+/* the default clock is RDTSCP or RDTSC if enabled at compile time, MPI_Wtime otherwise */
+int reprompi_is_clock_available(const reprompi_clock_type_t type);
+void reprompi_select_clock(const reprompi_clock_type_t type);
+reprompi_clock_type_t reprompi_get_clock(void);
+/* returns 1 if all processes of a node read the same clock (MPI_Wtime may be relative to the start of each process) */
+int reprompi_is_clock_shared(const reprompi_clock_type_t type);
+const char* reprompi_get_clock_name(const reprompi_clock_type_t type);
+/* case-insensitive lookup; returns 1 if there is no clock with this name */
+int reprompi_get_clock_by_name(const char* name, reprompi_clock_type_t* type);
+
+/* collective over MPI_COMM_WORLD: collects the timer frequency of each process on rank 0
+ * and measures the overhead and resolution of all available clocks on rank 0 */
+void gather_time_parameters(void);
+
 double get_time(void);
 
+/* get_ticks() only reads the timer; ticks_to_sec converts a tick count (or a
+ * difference of tick counts) into seconds, so that get_time() == ticks_to_sec(get_ticks()) */
+reprompi_ticks_t get_ticks(void);
+double ticks_to_sec(const reprompi_ticks_t ticks);
+
+/*
+ * Collective over MPI_COMM_WORLD: each process measures the overhead (mean time
+ * between two back-to-back calls) and the resolution (smallest non-zero step) of the
+ * timer used in the measurement loop, which are printed by print_time_parameters.
+ * reprompi_calibrate_timer measures get_time_fn, reprompi_calibrate_ticks measures get_ticks.
+ */
+void reprompi_calibrate_timer(double (*get_time_fn)(void));
+void reprompi_calibrate_ticks(void);
+/* overhead of the calling process, 0 before the calibration */
+double reprompi_get_timer_overhead(void);
+reprompi_ticks_t reprompi_get_timer_overhead_ticks(void);
+
 void print_time_parameters(FILE* f);
 
 #endif /* REPROMPIB_TIME_MEASUREMENT_H_ */
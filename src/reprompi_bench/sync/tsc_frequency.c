@@ -0,0 +1,185 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "tsc_frequency.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define HAVE_X86_TSC 1
+#endif
+
+static const char* const tsc_freq_source_names[] = {
+        [TSC_FREQ_SOURCE_FIXED] = "fixed",
+        [TSC_FREQ_SOURCE_CPUID] = "cpuid",
+        [TSC_FREQ_SOURCE_CALIBRATION] = "calibration"
+};
+static const int N_TSC_FREQ_SOURCES = 3;
+
+// each calibration round spins for this long; the median of the rounds is used
+static const double CALIBRATION_ROUND_SEC = 0.01;
+#define CALIBRATION_ROUNDS 3
+static const int CALIBRATION_READ_TRIES = 5;
+
+
+const char* reprompi_get_tsc_freq_source_name(reprompi_tsc_freq_source_t source) {
+    if (source < 0 || source >= N_TSC_FREQ_SOURCES) {
+        return "unknown";
+    }
+    return tsc_freq_source_names[source];
+}
+
+
+#ifdef HAVE_X86_TSC
+
+enum { EAX = 0, EBX, ECX, EDX };
+
+static void read_cpuid(const unsigned int leaf, unsigned int regs[4]) {
+    __cpuid(leaf, regs[EAX], regs[EBX], regs[ECX], regs[EDX]);
+}
+
+
+int reprompi_tsc_is_invariant(void) {
+    unsigned int regs[4];
+
+    if (__get_cpuid_max(0x80000000, NULL) < 0x80000007) {
+        return 0;
+    }
+    read_cpuid(0x80000007, regs);
+    return (regs[EDX] >> 8) & 1;
+}
+
+
+/*
+ * TSC frequency = crystal frequency * EBX / EAX (leaf 0x15). Some CPUs do not
+ * report the crystal frequency; as in Linux, it is then derived from the base
+ * frequency of leaf 0x16, which equals the TSC frequency on these CPUs.
+ */
+static double frequency_from_cpuid(void) {
+    unsigned int max_leaf;
+    unsigned int regs[4];
+
+    max_leaf = __get_cpuid_max(0, NULL);
+    if (max_leaf < 0x15) {
+        return 0;
+    }
+    // EAX: denominator, EBX: numerator of the TSC/crystal ratio, ECX: crystal frequency in Hz
+    read_cpuid(0x15, regs);
+    if (regs[EAX] == 0 || regs[EBX] == 0) {
+        return 0;
+    }
+    if (regs[ECX] == 0) {
+        if (max_leaf < 0x16) {
+            return 0;
+        }
+        // leaf 0x16, EAX: base frequency in MHz
+        read_cpuid(0x16, regs);
+        return (double)regs[EAX] * 1e6;
+    }
+    return (double)regs[ECX] * regs[EBX] / regs[EAX];
+}
+
+
+static double get_raw_time(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+/* reads CLOCK_MONOTONIC_RAW together with the TSC, keeping the read with the tightest TSC bracket */
+static void read_tsc_and_raw_time(uint64_t* tsc, double* raw_time) {
+    int i;
+    uint64_t before, after, min_gap = UINT64_MAX;
+    double t;
+
+    *tsc = 0;
+    *raw_time = 0;
+    for (i = 0; i < CALIBRATION_READ_TRIES; i++) {
+        before = __builtin_ia32_rdtsc();
+        t = get_raw_time();
+        after = __builtin_ia32_rdtsc();
+        if (after - before < min_gap) {
+            min_gap = after - before;
+            *tsc = before + (after - before) / 2;
+            *raw_time = t;
+        }
+    }
+}
+
+
+static double frequency_from_calibration(void) {
+    int i, j;
+    uint64_t tsc_start, tsc_end;
+    double t_start, t_end, tmp;
+    double freq[CALIBRATION_ROUNDS];
+
+    for (i = 0; i < CALIBRATION_ROUNDS; i++) {
+        read_tsc_and_raw_time(&tsc_start, &t_start);
+        while (get_raw_time() - t_start < CALIBRATION_ROUND_SEC) {
+        }
+        read_tsc_and_raw_time(&tsc_end, &t_end);
+        freq[i] = (double)(tsc_end - tsc_start) / (t_end - t_start);
+
+        // insertion sort to get the median
+        for (j = i; j > 0 && freq[j - 1] > freq[j]; j--) {
+            tmp = freq[j];
+            freq[j] = freq[j - 1];
+            freq[j - 1] = tmp;
+        }
+    }
+    // rounded to kHz like the tsc_khz of the kernel, so that processes with the same TSC report the same value
+    return (double)(uint64_t)(freq[CALIBRATION_ROUNDS / 2] * 1e-3 + 0.5) * 1e3;
+}
+
+
+double reprompi_tsc_discover_frequency(reprompi_tsc_freq_source_t* source) {
+    double freq;
+
+    freq = frequency_from_cpuid();
+    if (freq > 0) {
+        *source = TSC_FREQ_SOURCE_CPUID;
+        return freq;
+    }
+    *source = TSC_FREQ_SOURCE_CALIBRATION;
+    return frequency_from_calibration();
+}
+
+#else
+
+int reprompi_tsc_is_invariant(void) {
+    return 0;
+}
+
+double reprompi_tsc_discover_frequency(reprompi_tsc_freq_source_t* source) {
+    *source = TSC_FREQ_SOURCE_FIXED;
+    return 0;
+}
+
+#endif
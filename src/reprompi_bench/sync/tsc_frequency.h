@@ -0,0 +1,45 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPI_TSC_FREQUENCY_H_
+#define REPROMPI_TSC_FREQUENCY_H_
+
+typedef enum {
+    TSC_FREQ_SOURCE_FIXED = 0,      /* FREQUENCY_MHZ given at compile time */
+    TSC_FREQ_SOURCE_CPUID,          /* CPUID leaf 0x15 (crystal clock and TSC ratio) */
+    TSC_FREQ_SOURCE_CALIBRATION     /* calibration against CLOCK_MONOTONIC_RAW */
+} reprompi_tsc_freq_source_t;
+
+/* returns 1 if the CPU reports an invariant TSC (constant rate in all P-, C- and T-states) */
+int reprompi_tsc_is_invariant(void);
+
+/*
+ * Frequency of the TSC of the calling process in Hz, taken from CPUID leaf 0x15
+ * if the CPU provides it, or a calibration against CLOCK_MONOTONIC_RAW (a few 10 ms).
+ * Returns 0 if no source is available (not an x86 CPU).
+ */
+double reprompi_tsc_discover_frequency(reprompi_tsc_freq_source_t* source);
+
+const char* reprompi_get_tsc_freq_source_name(reprompi_tsc_freq_source_t source);
+
+#endif /* REPROMPI_TSC_FREQUENCY_H_ */
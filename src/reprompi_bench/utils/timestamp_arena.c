@@ -0,0 +1,132 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+ Research Group for Parallel Computing
+ Faculty of Informatics
+ Vienna University of Technology, Austria
+
+ <license>
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ </license>
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "timestamp_arena.h"
+
+#if defined(MAP_ANONYMOUS)
+#define REPROMPI_MAP_ANON MAP_ANONYMOUS
+#else
+#define REPROMPI_MAP_ANON MAP_ANON
+#endif
+
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static size_t round_up(const size_t size, const size_t align) {
+  return ((size + align - 1) / align) * align;
+}
+
+static void* map_anonymous(const size_t size, const int extra_flags) {
+  void* p;
+
+  p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | REPROMPI_MAP_ANON | extra_flags, -1, 0);
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+  return p;
+}
+
+
+int reprompi_arena_init(reprompi_timestamp_arena_t* arena, const size_t size, const int flags) {
+  size_t page_size;
+  long sys_page_size;
+
+  arena->base = NULL;
+  arena->size = 0;
+  arena->locked = 0;
+  arena->huge_pages = 0;
+
+  sys_page_size = sysconf(_SC_PAGESIZE);
+  page_size = (sys_page_size > 0) ? (size_t) sys_page_size : 4096;
+  if (size == 0) {
+    return 1;
+  }
+
+  if (flags & REPROMPI_ARENA_HUGE_PAGES) {
+    arena->size = round_up(size, HUGE_PAGE_SIZE);
+#if defined(MAP_HUGETLB)
+    // explicit huge pages are only available if the administrator reserved them
+    arena->base = map_anonymous(arena->size, MAP_HUGETLB);
+    if (arena->base != NULL) {
+      arena->huge_pages = 1;
+    }
+#endif
+    if (arena->base == NULL) {
+      arena->base = map_anonymous(arena->size, 0);
+#if defined(MADV_HUGEPAGE)
+      // fall back to transparent huge pages
+      if (arena->base != NULL && madvise(arena->base, arena->size, MADV_HUGEPAGE) == 0) {
+        arena->huge_pages = 1;
+      }
+#endif
+    }
+  } else {
+    arena->size = round_up(size, page_size);
+    arena->base = map_anonymous(arena->size, 0);
+  }
+
+  if (arena->base == NULL) {
+    arena->size = 0;
+    return 1;
+  }
+
+  // touch every page now, so that no page fault occurs in the measurement loop
+  memset(arena->base, 0, arena->size);
+
+  if (flags & REPROMPI_ARENA_LOCK) {
+    if (mlock(arena->base, arena->size) == 0) {
+      arena->locked = 1;
+    }
+  }
+
+  return 0;
+}
+
+
+void reprompi_arena_free(reprompi_timestamp_arena_t* arena) {
+  if (arena->base != NULL) {
+    if (arena->locked) {
+      munlock(arena->base, arena->size);
+    }
+    munmap(arena->base, arena->size);
+  }
+  arena->base = NULL;
+  arena->size = 0;
+  arena->locked = 0;
+  arena->huge_pages = 0;
+}
+
+
+void* reprompi_arena_get_array(const reprompi_timestamp_arena_t* arena, const int n, const size_t nelems,
+    const size_t elem_size) {
+  if (arena->base == NULL || (n + 1) * nelems * elem_size > arena->size) {
+    return NULL;
+  }
+  return (char*) arena->base + n * nelems * elem_size;
+}
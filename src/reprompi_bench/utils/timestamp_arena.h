@@ -0,0 +1,51 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+*/
+
+#ifndef REPROMPIB_TIMESTAMP_ARENA_H_
+#define REPROMPIB_TIMESTAMP_ARENA_H_
+
+#include <stddef.h>
+
+enum reprompi_arena_flags {
+  REPROMPI_ARENA_LOCK = 0x01,       /* mlock the arena */
+  REPROMPI_ARENA_HUGE_PAGES = 0x02  /* back the arena with huge pages if possible */
+};
+
+/* memory for the timestamps of the measurement loop, mapped and
+ * pre-faulted once and reused by all jobs */
+typedef struct reprompi_timestamp_arena {
+  void* base;
+  size_t size;
+  int locked;
+  int huge_pages;
+} reprompi_timestamp_arena_t;
+
+
+int reprompi_arena_init(reprompi_timestamp_arena_t* arena, const size_t size, const int flags);
+void reprompi_arena_free(reprompi_timestamp_arena_t* arena);
+
+/* the n-th of the arrays of nelems elements of elem_size bytes stored in the arena */
+void* reprompi_arena_get_array(const reprompi_timestamp_arena_t* arena, const int n, const size_t nelems,
+    const size_t elem_size);
+
+#endif /* REPROMPIB_TIMESTAMP_ARENA_H_ */
@@ -0,0 +1,296 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "mpi.h"
+
+#include "reprompi_bench/sync/time_measurement.h"
+#include "reprompi_bench/sync/sync_pingpong.h"
+#include "reprompi_bench/sync/node_sync.h"
+#include "drift_survey.h"
+
+#include <gsl/gsl_fit.h>
+#include <gsl/gsl_sort.h>
+#include <gsl/gsl_statistics.h>
+
+static const int OUTPUT_ROOT_PROC = 0;
+
+/* nodes whose drift differs from the median by more than this many (normalized) MADs are flagged */
+static const double OUTLIER_MADS = 5.0;
+static const double MAD_TO_SD = 1.4826;
+
+static const char* const pattern_names[] = {
+        [DRIFT_SURVEY_TREE] = "tree",
+        [DRIFT_SURVEY_TOURNAMENT] = "tournament"
+};
+
+
+static int highest_bit(const int rank) {
+    int bit = 1;
+    while (bit * 2 <= rank) {
+        bit *= 2;
+    }
+    return bit;
+}
+
+/* tree: the parent clears the highest bit, tournament: the parent clears the lowest bit */
+static int get_parent(const int rank, const reprompi_drift_survey_pattern_t pattern) {
+    if (pattern == DRIFT_SURVEY_TREE) {
+        return rank - highest_bit(rank);
+    }
+    return rank & (rank - 1);
+}
+
+/* round in which rank (> 0) measures its offset to its parent */
+static int get_round(const int rank, const reprompi_drift_survey_pattern_t pattern) {
+    int bit, round = 0;
+
+    bit = (pattern == DRIFT_SURVEY_TREE) ? highest_bit(rank) : (rank & -rank);
+    while (bit > 1) {
+        bit /= 2;
+        round++;
+    }
+    return round;
+}
+
+/* child of rank in the given round, or -1 */
+static int get_child(const int rank, const int round, const int nprocs,
+        const reprompi_drift_survey_pattern_t pattern) {
+    int child = rank + (1 << round);
+
+    if (child >= nprocs) {
+        return -1;
+    }
+    if (pattern == DRIFT_SURVEY_TREE) {
+        return (rank < (1 << round)) ? child : -1;
+    }
+    return (rank % (1 << (round + 1)) == 0) ? child : -1;
+}
+
+static void wait_until(const double target_time) {
+    double remaining = target_time - get_time();
+    struct timespec sleep_time;
+
+    if (remaining > 0) {
+        sleep_time.tv_sec = (time_t)remaining;
+        sleep_time.tv_nsec = (long)((remaining - sleep_time.tv_sec) * 1e9);
+        nanosleep(&sleep_time, NULL);
+    }
+}
+
+/* one offset sample of every process to its parent; returns the offset on the child (0 on the root) */
+static double measure_offset_to_parent(MPI_Comm comm, const reprompi_drift_survey_params_t* params,
+        const int n_rounds, double* sample_time) {
+    int my_rank, nprocs, round, child;
+    double offset = 0;
+
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &nprocs);
+
+    *sample_time = get_time();
+    for (round = 0; round < n_rounds; round++) {
+        if (my_rank > 0 && get_round(my_rank, params->pattern) == round) {
+            *sample_time = get_time();
+            offset = reprompi_sync_pingpong_min_rtt_offset(my_rank, get_parent(my_rank, params->pattern),
+                    params->n_pingpongs, comm, get_time, NULL);
+        } else {
+            child = get_child(my_rank, round, nprocs, params->pattern);
+            if (child >= 0) {
+                reprompi_sync_pingpong_min_rtt_offset(child, my_rank, params->n_pingpongs, comm, get_time, NULL);
+            }
+        }
+    }
+    return offset;
+}
+
+static void print_drift_survey(FILE* f, const reprompi_drift_survey_params_t* params, const int nprocs,
+        const int n_rounds, const double duration_sec, const int* world_ranks, const char* hostnames,
+        const double* drift, const double* offset) {
+    int i, bin, n_outliers = 0;
+    double* sorted;
+    double* deviation;
+    double median, mad, min, max, bin_width;
+    int* outlier;
+    int* histogram;
+
+    sorted = (double*) malloc(nprocs * sizeof(double));
+    deviation = (double*) malloc(nprocs * sizeof(double));
+    outlier = (int*) calloc(nprocs, sizeof(int));
+    histogram = (int*) calloc(params->n_bins, sizeof(int));
+
+    memcpy(sorted, drift, nprocs * sizeof(double));
+    gsl_sort(sorted, 1, nprocs);
+    median = gsl_stats_median_from_sorted_data(sorted, 1, nprocs);
+    min = sorted[0];
+    max = sorted[nprocs - 1];
+    for (i = 0; i < nprocs; i++) {
+        deviation[i] = fabs(drift[i] - median);
+    }
+    gsl_sort(deviation, 1, nprocs);
+    mad = MAD_TO_SD * gsl_stats_median_from_sorted_data(deviation, 1, nprocs);
+
+    for (i = 0; i < nprocs; i++) {
+        if (mad > 0 && fabs(drift[i] - median) > OUTLIER_MADS * mad) {
+            outlier[i] = 1;
+            n_outliers++;
+        }
+    }
+
+    bin_width = (max - min) / params->n_bins;
+    for (i = 0; i < nprocs; i++) {
+        bin = (bin_width > 0) ? (int)((drift[i] - min) / bin_width) : 0;
+        if (bin >= params->n_bins) {
+            bin = params->n_bins - 1;
+        }
+        histogram[bin]++;
+    }
+
+    fprintf(f, "#@drift_survey_pattern=%s\n", pattern_names[params->pattern]);
+    fprintf(f, "#@drift_survey_scope=%s\n", params->all_ranks ? "processes" : "nodes");
+    fprintf(f, "#@drift_survey_nodes=%d\n", nprocs);
+    fprintf(f, "#@drift_survey_rounds=%d\n", n_rounds);
+    fprintf(f, "#@drift_survey_samples=%d\n", params->n_samples);
+    fprintf(f, "#@drift_survey_pingpongs=%d\n", params->n_pingpongs);
+    fprintf(f, "#@drift_survey_horizon_s=%.6f\n", params->horizon_sec);
+    fprintf(f, "#@drift_survey_duration_s=%.6f\n", duration_sec);
+    fprintf(f, "#@drift_rate_min=%.4e\n", min);
+    fprintf(f, "#@drift_rate_median=%.4e\n", median);
+    fprintf(f, "#@drift_rate_max=%.4e\n", max);
+    fprintf(f, "#@drift_rate_mad=%.4e\n", mad);
+    fprintf(f, "#@drift_rate_outliers=%d\n", n_outliers);
+    for (bin = 0; bin < params->n_bins; bin++) {
+        fprintf(f, "#@drift_histogram_bin%d=%.4e,%.4e,%d\n", bin,
+                min + bin * bin_width, min + (bin + 1) * bin_width, histogram[bin]);
+    }
+
+    fprintf(f, "%6s %6s %30s %14s %14s %8s\n", "node", "rank", "host", "drift_rate", "offset_s", "outlier");
+    for (i = 0; i < nprocs; i++) {
+        fprintf(f, "%6d %6d %30s %14.4e %14.9f %8d\n", i, world_ranks[i],
+                hostnames + i * MPI_MAX_PROCESSOR_NAME, drift[i], offset[i], outlier[i]);
+    }
+
+    free(sorted);
+    free(deviation);
+    free(outlier);
+    free(histogram);
+}
+
+static void survey_comm(MPI_Comm comm, const reprompi_drift_survey_params_t* params) {
+    int my_rank, nprocs, n_rounds, s, i, len;
+    int world_rank;
+    double interval_sec, start_time, duration_sec;
+    double c0, c1, cov00, cov01, cov11, sumsq;
+    double my_drift = 0, my_offset;
+    double *sample_times, *offsets;
+    double *parent_drift = NULL, *parent_offset = NULL;
+    int* world_ranks = NULL;
+    char my_hostname[MPI_MAX_PROCESSOR_NAME];
+    char* hostnames = NULL;
+
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &nprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    n_rounds = 0;
+    while ((1 << n_rounds) < nprocs) {
+        n_rounds++;
+    }
+
+    sample_times = (double*) malloc(params->n_samples * sizeof(double));
+    offsets = (double*) malloc(params->n_samples * sizeof(double));
+    interval_sec = params->horizon_sec / (params->n_samples - 1);
+
+    MPI_Barrier(comm);
+    start_time = get_time();
+    for (s = 0; s < params->n_samples; s++) {
+        if (s > 0) {
+            wait_until(start_time + s * interval_sec);
+            MPI_Barrier(comm);
+        }
+        offsets[s] = measure_offset_to_parent(comm, params, n_rounds, &sample_times[s]);
+    }
+    duration_sec = get_time() - start_time;
+
+    if (my_rank > 0) {
+        gsl_fit_linear(sample_times, 1, offsets, 1, params->n_samples, &c0, &c1, &cov00, &cov01, &cov11, &sumsq);
+        my_drift = c1;
+    }
+    my_offset = offsets[params->n_samples - 1];
+    memset(my_hostname, 0, MPI_MAX_PROCESSOR_NAME);
+    MPI_Get_processor_name(my_hostname, &len);
+
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        parent_drift = (double*) malloc(nprocs * sizeof(double));
+        parent_offset = (double*) malloc(nprocs * sizeof(double));
+        world_ranks = (int*) malloc(nprocs * sizeof(int));
+        hostnames = (char*) malloc(nprocs * MPI_MAX_PROCESSOR_NAME * sizeof(char));
+    }
+    MPI_Gather(&my_drift, 1, MPI_DOUBLE, parent_drift, 1, MPI_DOUBLE, OUTPUT_ROOT_PROC, comm);
+    MPI_Gather(&my_offset, 1, MPI_DOUBLE, parent_offset, 1, MPI_DOUBLE, OUTPUT_ROOT_PROC, comm);
+    MPI_Gather(&world_rank, 1, MPI_INT, world_ranks, 1, MPI_INT, OUTPUT_ROOT_PROC, comm);
+    MPI_Gather(my_hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, hostnames, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+            OUTPUT_ROOT_PROC, comm);
+
+    if (my_rank == OUTPUT_ROOT_PROC) {
+        // parents have lower ranks than their children in both patterns
+        parent_drift[0] = parent_offset[0] = 0;
+        for (i = 1; i < nprocs; i++) {
+            parent_drift[i] += parent_drift[get_parent(i, params->pattern)];
+            parent_offset[i] += parent_offset[get_parent(i, params->pattern)];
+        }
+        print_drift_survey(stdout, params, nprocs, n_rounds, duration_sec, world_ranks, hostnames,
+                parent_drift, parent_offset);
+
+        free(parent_drift);
+        free(parent_offset);
+        free(world_ranks);
+        free(hostnames);
+    }
+
+    free(sample_times);
+    free(offsets);
+}
+
+void reprompi_run_drift_survey(const reprompi_drift_survey_params_t* params) {
+    MPI_Comm node_comm, leaders_comm;
+
+    if (params->all_ranks) {
+        survey_comm(MPI_COMM_WORLD, params);
+        reprompi_sync_pingpong_cleanup();
+        return;
+    }
+
+    // the processes of a node share the clock, so only the node leaders are surveyed
+    reprompi_create_node_comms(&node_comm, &leaders_comm);
+    if (leaders_comm != MPI_COMM_NULL) {
+        survey_comm(leaders_comm, params);
+    }
+    reprompi_free_node_comms(&node_comm, &leaders_comm);
+    reprompi_sync_pingpong_cleanup();
+}
@@ -0,0 +1,52 @@
+/*  ReproMPI Benchmark
+ *
+ *  Copyright 2015 Alexandra Carpen-Amarie, Sascha Hunold
+    Research Group for Parallel Computing
+    Faculty of Informatics
+    Vienna University of Technology, Austria
+
+<license>
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+</license>
+ */
+
+#ifndef REPROMPI_DRIFT_SURVEY_H_
+#define REPROMPI_DRIFT_SURVEY_H_
+
+typedef enum {
+    DRIFT_SURVEY_TREE = 0,      /* binomial tree from the root: round k doubles the number of measured processes */
+    DRIFT_SURVEY_TOURNAMENT     /* tournament: round k pairs the winners of round k-1, p/2 pairs in the first round */
+} reprompi_drift_survey_pattern_t;
+
+typedef struct {
+    reprompi_drift_survey_pattern_t pattern;
+    double horizon_sec;     /* time between the first and the last sample */
+    int n_samples;          /* offset samples per process */
+    int n_bins;             /* bins of the drift histogram */
+    int n_pingpongs;        /* ping-pongs per offset measurement */
+    int all_ranks;          /* survey every process instead of one process per node */
+} reprompi_drift_survey_params_t;
+
+/*
+ * Collective over MPI_COMM_WORLD. Measures the clock drift of all nodes (or all
+ * processes) relative to the root in parallel: each process measures its clock
+ * offset to its parent in the tree given by the pattern, all pairs of a round at
+ * the same time, n_samples times over the horizon. The drift rate to the parent is
+ * the slope of a linear fit of these offsets, the drift rate to the root is the sum
+ * of the rates along the path to the root.
+ * The root prints a drift histogram and the drift rate of each node.
+ */
+void reprompi_run_drift_survey(const reprompi_drift_survey_params_t* params);
+
+#endif /* REPROMPI_DRIFT_SURVEY_H_ */
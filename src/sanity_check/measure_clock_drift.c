@@ -31,6 +31,7 @@
 #include "reprompi_bench/sync/synchronization.h"
 #include "reprompi_bench/sync/time_measurement.h"
 #include "parse_test_options.h"
+#include "drift_survey.h"
 
 #include <gsl/gsl_statistics.h>
 #include <gsl/gsl_fit.h>
@@ -133,6 +134,7 @@ void print_initial_settings(int argc, char* argv[], reprompib_st_opts_t opts,
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &np);
+    gather_time_parameters();
 
     f = stdout;
     if (my_rank == OUTPUT_ROOT_PROC) {
@@ -181,7 +183,7 @@ int main(int argc, char* argv[]) {
 
     // initialize synchronization functions according to the configured synchronization method
     reprompib_sync_functions_t sync_f;
-    initialize_sync_implementation(&sync_f);
+    initialize_sync_implementation(argc, argv, &sync_f);
 
     init_timer();
 
@@ -200,6 +202,14 @@ int main(int argc, char* argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
 
+    if (opts.drift_survey) {
+        // the survey measures the raw clocks of all nodes in parallel and replaces the measurements below
+        print_initial_settings(argc, argv, opts, sync_f.print_sync_info);
+        reprompi_run_drift_survey(&opts.survey);
+        MPI_Finalize();
+        return 0;
+    }
+
     // compute RTTs
     n_pingpongs = 1000;
     p = 0;
@@ -31,16 +31,32 @@
 #include "mpi.h"
 #include "parse_test_options.h"
 
+enum {
+    TEST_ARGS_DRIFT_SURVEY = 500,
+    TEST_ARGS_SURVEY_PATTERN,
+    TEST_ARGS_SURVEY_HORIZON,
+    TEST_ARGS_SURVEY_SAMPLES,
+    TEST_ARGS_SURVEY_BINS,
+    TEST_ARGS_SURVEY_ALL_RANKS
+};
+
 static const struct option default_long_options[] = {
         { "repetitions", required_argument, 0, 'r' },
         { "help", no_argument, 0, 'h' },
+        { "drift-survey", no_argument, 0, TEST_ARGS_DRIFT_SURVEY },
+        { "survey-pattern", required_argument, 0, TEST_ARGS_SURVEY_PATTERN },
+        { "survey-horizon", required_argument, 0, TEST_ARGS_SURVEY_HORIZON },
+        { "survey-samples", required_argument, 0, TEST_ARGS_SURVEY_SAMPLES },
+        { "survey-bins", required_argument, 0, TEST_ARGS_SURVEY_BINS },
+        { "survey-all-ranks", no_argument, 0, TEST_ARGS_SURVEY_ALL_RANKS },
         { 0, 0, 0, 0 }
 };
 
 
 static char * const error_messages[] =
         { "",
-          "Number of repetitions null or not specified"
+          "Number of repetitions null or not specified",
+          "Invalid drift survey parameters (pattern: tree or tournament, horizon > 0, samples >= 2, bins >= 1)"
         };
 static const int N_ERRORS = sizeof(error_messages) / sizeof(error_messages[0]);
 
@@ -75,10 +91,26 @@ void print_help(char* testname) {
             printf("%-40s %-40s\n", "<steps>",
                     "set number of 1s steps to wait after sync (default: 0)");
 
+            printf("\nDrift survey (measures the drift of all nodes in parallel instead):\n");
+            printf("%-40s %-40s\n", "--drift-survey",
+                    "measure the clock drift of each node relative to the root (-r sets the ping-pongs per offset)");
+            printf("%-40s %-40s\n", "--survey-pattern=<pattern>",
+                    "tree or tournament (default: tree)");
+            printf("%-40s %-40s\n", "--survey-horizon=<sec>",
+                    "time between the first and the last offset sample (default: 10)");
+            printf("%-40s %-40s\n", "--survey-samples=<n>",
+                    "offset samples per node (default: 10)");
+            printf("%-40s %-40s\n", "--survey-bins=<n>",
+                    "bins of the drift histogram (default: 10)");
+            printf("%-40s %-40s\n", "--survey-all-ranks",
+                    "survey every process instead of one process per node");
+
             printf(
                     "\nEXAMPLES: mpirun -np 4 %s -r 5 --window-size=100 --fitpoints=10 --exchanges=20 5\n", testname);
             printf(
                     "\n          mpirun -np 4 %s -r 5 --window-size=100 \n", testname);
+            printf(
+                    "\n          mpirun -np 4 %s --repetitions=20 --window-size=100 --drift-survey --survey-horizon=60\n", testname);
         }
         else {
             printf(
@@ -96,6 +128,13 @@ void print_help(char* testname) {
 void init_parameters(reprompib_st_opts_t* opts_p, char* name) {
     opts_p->n_rep = 0;
     opts_p->steps = 0;
+    opts_p->drift_survey = 0;
+    opts_p->survey.pattern = DRIFT_SURVEY_TREE;
+    opts_p->survey.horizon_sec = 10;
+    opts_p->survey.n_samples = 10;
+    opts_p->survey.n_bins = 10;
+    opts_p->survey.n_pingpongs = 0;
+    opts_p->survey.all_ranks = 0;
     strcpy(opts_p->testname,name);
 }
 
@@ -104,6 +143,7 @@ reprompib_st_error_t parse_test_options(reprompib_st_opts_t* opts_p, int argc, c
     int c;
     reprompib_st_error_t ret = SUCCESS;
     int printhelp = 0;
+    int survey_error = 0;
 
     init_parameters(opts_p, argv[0]);
 
@@ -129,6 +169,30 @@ reprompib_st_error_t parse_test_options(reprompib_st_opts_t* opts_p, int argc, c
             print_help(opts_p->testname);
             printhelp = 1;
             break;
+        case TEST_ARGS_DRIFT_SURVEY:
+            opts_p->drift_survey = 1;
+            break;
+        case TEST_ARGS_SURVEY_PATTERN:
+            if (strcmp(optarg, "tree") == 0) {
+                opts_p->survey.pattern = DRIFT_SURVEY_TREE;
+            } else if (strcmp(optarg, "tournament") == 0) {
+                opts_p->survey.pattern = DRIFT_SURVEY_TOURNAMENT;
+            } else {
+                survey_error = 1;
+            }
+            break;
+        case TEST_ARGS_SURVEY_HORIZON:
+            opts_p->survey.horizon_sec = atof(optarg);
+            break;
+        case TEST_ARGS_SURVEY_SAMPLES:
+            opts_p->survey.n_samples = atoi(optarg);
+            break;
+        case TEST_ARGS_SURVEY_BINS:
+            opts_p->survey.n_bins = atoi(optarg);
+            break;
+        case TEST_ARGS_SURVEY_ALL_RANKS:
+            opts_p->survey.all_ranks = 1;
+            break;
         case '?':
             break;
         }
@@ -137,6 +201,11 @@ reprompib_st_error_t parse_test_options(reprompib_st_opts_t* opts_p, int argc, c
     if (opts_p->n_rep <= 0) {
         ret |= ERROR_NREP_NULL;
     }
+    opts_p->survey.n_pingpongs = opts_p->n_rep;
+    if (opts_p->drift_survey && ret == SUCCESS && (survey_error || opts_p->survey.horizon_sec <= 0
+            || opts_p->survey.n_samples < 2 || opts_p->survey.n_bins < 1)) {
+        ret = ERROR_DRIFT_SURVEY;
+    }
 
     if (printhelp) {
         ret = SUCCESS;
@@ -25,16 +25,21 @@
 #ifndef PARSE_TEST_OPTIONS_H_
 #define PARSE_TEST_OPTIONS_H_
 
+#include "drift_survey.h"
+
 
 typedef enum {
     SUCCESS = 0,
-    ERROR_NREP_NULL
+    ERROR_NREP_NULL,
+    ERROR_DRIFT_SURVEY
 } reprompib_st_error_t;
 
 
 typedef struct opt {
     long n_rep; /* --repetitions */
     int steps;  /* --steps */
+    int drift_survey; /* --drift-survey */
+    reprompi_drift_survey_params_t survey; /* --survey-* */
     char testname[256];
 } reprompib_st_opts_t;
 
@@ -41,6 +41,7 @@ void print_initial_settings(int argc, char* argv[],
     FILE* f;
 
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    gather_time_parameters();
 
     f = stdout;
     if (my_rank == OUTPUT_ROOT_PROC) {
@@ -72,7 +73,7 @@ int main(int argc, char* argv[]) {
 
     // initialize synchronization functions according to the configured synchronization method
     reprompib_sync_functions_t sync_f;
-    initialize_sync_implementation(&sync_f);
+    initialize_sync_implementation(argc, argv, &sync_f);
 
     init_timer();
 